@@ -0,0 +1,131 @@
+// Compares AdaptiveConsumer with fixed batch limits on a bursty load.
+// One thread replays an arrival schedule that alternates quiet and burst
+// phases: before every poll it pushes each element whose arrival time has
+// passed, stamped with that time. Each batch pays a fixed overhead (think of
+// a flush or a system call) and each element a fixed amount of work, both
+// busy-waited. Each line reports the batch count and the latency from
+// arrival to handling.
+//
+//   bench_adaptive_batch [--ms 400] [--quiet-rate 100000] [--burst-rate 3000000]
+//                        [--phase-ms 20] [--batch-overhead-ns 2000] [--work-ns 100]
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "ringbuff.hpp"
+#include "ringbuff_adaptive.hpp"
+#include "ringbuff_clock.hpp"
+
+namespace {
+
+struct Load {
+    uint64_t duration_ticks;
+    uint64_t phase_ticks;        // Length of each quiet and each burst phase
+    double quiet_per_tick;       // Arrivals per tick in quiet phases
+    double burst_per_tick;       // Arrivals per tick in bursts
+    uint64_t overhead_ticks;     // Cost of one batch
+    uint64_t work_ticks;         // Cost of one element
+};
+
+void spin_until(uint64_t deadline) {
+    while (TscClock::now() < deadline) {
+    }
+}
+
+// Builds the arrival times, in ticks from the start, of a quiet/burst schedule.
+std::vector<uint64_t> schedule(const Load& load) {
+    std::vector<uint64_t> arrivals;
+    double t = 0;
+    while (t < static_cast<double>(load.duration_ticks)) {
+        const bool burst = (static_cast<uint64_t>(t) / load.phase_ticks) % 2 == 1;
+        arrivals.push_back(static_cast<uint64_t>(t));
+        t += 1.0 / (burst ? load.burst_per_tick : load.quiet_per_tick);
+    }
+    return arrivals;
+}
+
+template <typename Poll>
+void run(const char* name, const Load& load, const std::vector<uint64_t>& arrivals, Poll&& poll) {
+    RingBuffer<uint64_t> ring(arrivals.size());
+    std::vector<uint64_t> latency;
+    latency.reserve(arrivals.size());
+    uint64_t batches = 0;
+    size_t next = 0;
+
+    const uint64_t start = TscClock::now();
+    auto handle = [&](uint64_t arrival) {
+        const uint64_t now = TscClock::now();
+        spin_until(now + load.work_ticks);
+        latency.push_back(now + load.work_ticks - arrival);
+    };
+    while (latency.size() < arrivals.size()) {
+        const uint64_t now = TscClock::now() - start;
+        while (next < arrivals.size() && arrivals[next] <= now) {
+            ring.try_push(start + arrivals[next++]);
+        }
+        if (ring.empty()) {
+            continue;
+        }
+        spin_until(TscClock::now() + load.overhead_ticks);
+        poll(ring, handle);
+        ++batches;
+    }
+
+    std::sort(latency.begin(), latency.end());
+    const TscClock& clock = TscClock::process();
+    auto us = [&](size_t index) { return static_cast<double>(clock.ticks_to_ns(latency[index])) / 1e3; };
+    std::printf("consumer=%s elements=%zu batches=%llu mean_batch=%.1f p50_us=%.1f p99_us=%.1f max_us=%.1f\n", name,
+                latency.size(), static_cast<unsigned long long>(batches),
+                static_cast<double>(latency.size()) / static_cast<double>(batches), us(latency.size() / 2),
+                us(latency.size() * 99 / 100), us(latency.size() - 1));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const TscClock& clock = TscClock::process();
+        const double ticks_per_ns = clock.ticks_per_second() / 1e9;
+        Load load{};
+        load.duration_ticks = static_cast<uint64_t>(bench::flag_double(argc, argv, "ms", 400) * 1e6 * ticks_per_ns);
+        load.phase_ticks = static_cast<uint64_t>(bench::flag_double(argc, argv, "phase-ms", 20) * 1e6 * ticks_per_ns);
+        load.quiet_per_tick = bench::flag_double(argc, argv, "quiet-rate", 100000) / 1e9 / ticks_per_ns;
+        load.burst_per_tick = bench::flag_double(argc, argv, "burst-rate", 3000000) / 1e9 / ticks_per_ns;
+        load.overhead_ticks =
+            static_cast<uint64_t>(bench::flag_double(argc, argv, "batch-overhead-ns", 2000) * ticks_per_ns);
+        load.work_ticks = static_cast<uint64_t>(bench::flag_double(argc, argv, "work-ns", 100) * ticks_per_ns);
+        if (load.duration_ticks == 0 || load.phase_ticks == 0 || load.quiet_per_tick <= 0 || load.burst_per_tick <= 0) {
+            std::fprintf(stderr, "bench_adaptive_batch: durations and rates must be positive\n");
+            return 1;
+        }
+        const std::vector<uint64_t> arrivals = schedule(load);
+
+        for (const size_t limit : {size_t{1}, size_t{16}, size_t{256}, size_t{4096}}) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "fixed_%zu", limit);
+            run(name, load, arrivals, [limit](RingBuffer<uint64_t>& ring, auto& handle) {
+                ring.consume([&](uint64_t arrival) { handle(arrival); }, limit);
+            });
+        }
+        AdaptiveBatchOptions options;
+        options.latency_budget = std::chrono::microseconds(50);
+        RingBuffer<uint64_t>* bound = nullptr;
+        std::unique_ptr<AdaptiveConsumer<RingBuffer<uint64_t>>> consumer;
+        run("adaptive", load, arrivals, [&](RingBuffer<uint64_t>& ring, auto& handle) {
+            if (bound != &ring) {
+                bound = &ring;
+                consumer = std::make_unique<AdaptiveConsumer<RingBuffer<uint64_t>>>(ring, options);
+            }
+            consumer->poll([&](uint64_t arrival) { handle(arrival); });
+        });
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_adaptive_batch: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
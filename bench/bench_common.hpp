@@ -0,0 +1,68 @@
+#ifndef RING_BUFFER_BENCH_COMMON_HPP
+#define RING_BUFFER_BENCH_COMMON_HPP
+
+#include <chrono>   // For std::chrono::steady_clock
+#include <cstddef>  // For size_t
+#include <cstdlib>  // For std::strtod, std::strtoull
+#include <string>   // For std::string
+
+// Small helpers shared by the benchmark drivers: flags of the form
+// `--name value` and wall-clock timing. Drivers print plain text, one result
+// per line, so runs can be diffed and grepped.
+namespace bench {
+
+// Returns the argument following `--name`, or fallback if the flag is absent.
+inline std::string flag(int argc, char** argv, const std::string& name, const std::string& fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == "--" + name) {
+            return argv[i + 1];
+        }
+    }
+    return fallback;
+}
+
+// Returns the numeric argument following `--name`, or fallback.
+inline size_t flag_size(int argc, char** argv, const std::string& name, size_t fallback) {
+    const std::string value = flag(argc, argv, name, "");
+    return value.empty() ? fallback : static_cast<size_t>(std::strtoull(value.c_str(), nullptr, 10));
+}
+
+// Returns the floating-point argument following `--name`, or fallback.
+inline double flag_double(int argc, char** argv, const std::string& name, double fallback) {
+    const std::string value = flag(argc, argv, name, "");
+    return value.empty() ? fallback : std::strtod(value.c_str(), nullptr);
+}
+
+// Checks whether `--name` appears on the command line.
+inline bool has_flag(int argc, char** argv, const std::string& name) {
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i] == "--" + name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Measures elapsed wall-clock time from construction.
+class Stopwatch {
+public:
+    Stopwatch() : start_(std::chrono::steady_clock::now()) {}
+
+    // Returns the elapsed time in nanoseconds.
+    double ns() const {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start_).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Keeps the compiler from discarding a computed value.
+template <typename T>
+inline void keep(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+}  // namespace bench
+
+#endif // RING_BUFFER_BENCH_COMMON_HPP
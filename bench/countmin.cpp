@@ -0,0 +1,120 @@
+// Measures WindowedCountMin::add() with random keys at a cache-resident and a
+// cache-missing row width, then tick() once the window is full. Every key's
+// estimate is checked against its exact count (no undercounts), and the
+// adds are checked to have expired once the window has moved past them.
+// A last check drives one key past UINT32_MAX and expires it again.
+//
+//   bench_countmin [--adds 4000000] [--keys 1048576] [--depth 4] [--epochs 8] [--ticks 200]
+
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "ringbuff_countmin.hpp"
+
+namespace {
+
+// Random key indices below `keys`, drawn before timing so the timed loop
+// only streams through them.
+std::vector<uint32_t> draw_keys(size_t adds, size_t keys) {
+    std::vector<uint32_t> drawn(adds);
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    for (uint32_t& key : drawn) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        key = static_cast<uint32_t>(state % keys);
+    }
+    return drawn;
+}
+
+// Returns false if an estimate undercounts or the adds do not expire.
+bool run(size_t width, size_t depth, size_t epochs, size_t keys, size_t ticks, const std::vector<uint32_t>& drawn) {
+    WindowedCountMin counts(width, depth, epochs);
+
+    const bench::Stopwatch add_watch;
+    for (const uint32_t key : drawn) {
+        counts.add(key);
+    }
+    const double add_ns = add_watch.ns();
+
+    std::vector<uint32_t> exact(keys);
+    for (const uint32_t key : drawn) {
+        ++exact[key];
+    }
+    size_t undercounts = 0;
+    double overcount = 0;
+    for (size_t key = 0; key < keys; ++key) {
+        const uint32_t estimate = counts.estimate(key);
+        undercounts += estimate < exact[key];
+        overcount += static_cast<double>(estimate - exact[key]);
+    }
+
+    // Moves the window past the adds, then times ticks that expire epochs.
+    for (size_t i = 0; i < epochs; ++i) {
+        counts.tick();
+    }
+    const bool expired = counts.total() == 0 && counts.estimate(drawn.front()) == 0;
+    const bench::Stopwatch tick_watch;
+    for (size_t i = 0; i < ticks; ++i) {
+        counts.tick();
+    }
+    const double tick_ns = tick_watch.ns();
+
+    std::printf("width=%zu depth=%zu memory_mb=%.1f ns_per_add=%.1f mean_overcount=%.2f undercounts=%zu "
+                "us_per_tick=%.1f expired=%s\n",
+                counts.width(), depth, static_cast<double>(counts.memory_bytes()) / (1 << 20),
+                add_ns / static_cast<double>(drawn.size()), overcount / static_cast<double>(keys), undercounts,
+                ticks == 0 ? 0.0 : tick_ns / 1e3 / static_cast<double>(ticks), expired ? "ok" : "FAILED");
+    return undercounts == 0 && expired;
+}
+
+// Adds 5, then 6e9 in two adds, then 7 occurrences of one key in three
+// epochs, and follows the estimate as they expire. A wrapping counter would
+// read 6e9 + 5 as about 1.7e9.
+bool check_saturation() {
+    WindowedCountMin counts(8, 2, 3);
+    const uint64_t key = 42;
+    counts.add(key, 5);
+    counts.tick();
+    counts.add(key, 3000000000u);
+    counts.add(key, 3000000000u);
+    const uint32_t saturated = counts.estimate(key);
+    counts.tick();
+    counts.add(key, 7);
+    counts.tick();  // Expires the 5; the 6e9 is still in the window
+    const uint32_t still_saturated = counts.estimate(key);
+    counts.tick();  // Expires the 6e9
+    const uint32_t after = counts.estimate(key);
+    const bool ok = saturated == UINT32_MAX && still_saturated == UINT32_MAX && after == 7 &&
+                    counts.total() == 7;
+    std::printf("check saturation estimates=%u,%u,%u expected=%u,%u,7 %s\n", saturated, still_saturated, after,
+                UINT32_MAX, UINT32_MAX, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const size_t adds = bench::flag_size(argc, argv, "adds", 4000000);
+        const size_t keys = bench::flag_size(argc, argv, "keys", 1 << 20);
+        const size_t depth = bench::flag_size(argc, argv, "depth", 4);
+        const size_t epochs = bench::flag_size(argc, argv, "epochs", 8);
+        const size_t ticks = bench::flag_size(argc, argv, "ticks", 200);
+        if (adds == 0 || keys == 0 || keys > UINT32_MAX) {
+            std::fprintf(stderr, "bench_countmin: need --adds > 0 and 0 < --keys <= 2^32 - 1\n");
+            return 1;
+        }
+        const std::vector<uint32_t> drawn = draw_keys(adds, keys);
+        bool ok = run(size_t{1} << 16, depth, epochs, keys, ticks, drawn);
+        ok &= run(size_t{1} << 20, depth, epochs, keys, ticks, drawn);
+        ok &= check_saturation();
+        return ok ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_countmin: %s\n", e.what());
+        return 1;
+    }
+}
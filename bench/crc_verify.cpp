@@ -0,0 +1,109 @@
+// Measures CRC-32C throughput with and without the CRC instructions, and the
+// rate at which verify() checks a byte ring full of frames that wrap around
+// its end. Afterwards it flips one payload byte in a copy of the frames and
+// checks that verify_frames() stops at the damaged record.
+//
+//   bench_crc_verify [--mb 64] [--record 256] [--passes 8]
+
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "ringbuff_crc32c.hpp"
+#include "ringbuff_framing.hpp"
+
+namespace {
+
+double gb_per_s(size_t bytes, double ns) {
+    return static_cast<double>(bytes) / ns;
+}
+
+template <typename Fn>
+void time_crc(const char* name, const std::vector<unsigned char>& data, size_t passes, Fn&& crc) {
+    uint32_t sum = 0;
+    const bench::Stopwatch watch;
+    for (size_t i = 0; i < passes; ++i) {
+        sum = crc(data.data(), data.size(), sum);
+    }
+    const double ns = watch.ns();
+    bench::keep(sum);
+    std::printf("crc=%s bytes=%zu passes=%zu gb_per_s=%.2f\n", name, data.size(), passes,
+                gb_per_s(data.size() * passes, ns));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const size_t bytes = bench::flag_size(argc, argv, "mb", 64) << 20;
+        const size_t record = bench::flag_size(argc, argv, "record", 256);
+        const size_t passes = bench::flag_size(argc, argv, "passes", 8);
+        if (bytes == 0 || record == 0 || passes == 0) {
+            std::fprintf(stderr, "bench_crc_verify: --mb, --record and --passes must be positive\n");
+            return 1;
+        }
+
+        std::vector<unsigned char> data(bytes);
+        uint64_t state = 0x9e3779b97f4a7c15ULL;
+        for (unsigned char& byte : data) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            byte = static_cast<unsigned char>(state);
+        }
+        std::printf("crc32c_hardware_accelerated=%d\n", crc32c_hardware_accelerated() ? 1 : 0);
+        time_crc("dispatch", data, passes, [](const void* p, size_t n, uint32_t c) { return crc32c(p, n, c); });
+        time_crc("portable", data, passes,
+                 [](const void* p, size_t n, uint32_t c) { return crc32c_portable(p, n, c); });
+
+        // Fill the ring, drain half and refill, so the stored frames wrap.
+        RingBuffer<std::byte> ring(bytes);
+        const std::vector<std::byte> payload(record, std::byte{0x42});
+        uint64_t sequence = 0;
+        while (try_push_frame(ring, sequence + 1, payload)) {
+            ++sequence;
+        }
+        uint64_t popped = 0;
+        std::vector<std::byte> out;
+        for (uint64_t i = 0; i < sequence / 2; ++i) {
+            try_pop_frame(ring, popped, out);
+        }
+        while (try_push_frame(ring, sequence + 1, payload)) {
+            ++sequence;
+        }
+
+        FrameCheck check;
+        const bench::Stopwatch watch;
+        for (size_t i = 0; i < passes; ++i) {
+            check = verify(ring, popped);
+        }
+        const double ns = watch.ns();
+        std::printf("verify bytes=%zu record=%zu records=%llu passes=%zu gb_per_s=%.2f intact=%d\n", ring.size(),
+                    record, static_cast<unsigned long long>(check.records), passes,
+                    gb_per_s(ring.size() * passes, ns), check.intact ? 1 : 0);
+        if (!check.intact || check.last_sequence != sequence) {
+            std::fprintf(stderr, "bench_crc_verify: verify rejected an intact ring\n");
+            return 1;
+        }
+
+        // Damage the payload of the middle record in a copy of the stored bytes.
+        const auto [first, second] = ring.segments();
+        std::vector<std::byte> head(first.begin(), first.end());
+        std::vector<std::byte> tail(second.begin(), second.end());
+        const size_t middle = (check.records / 2) * (frame_header_bytes + record) + frame_header_bytes;
+        (middle < head.size() ? head[middle] : tail[middle - head.size()]) ^= std::byte{1};
+        const FrameCheck damaged = verify_frames(head, tail, popped);
+        std::printf("damaged records=%llu intact=%d\n", static_cast<unsigned long long>(damaged.records),
+                    damaged.intact ? 1 : 0);
+        if (damaged.intact || damaged.records != check.records / 2) {
+            std::fprintf(stderr, "bench_crc_verify: verify missed a flipped byte\n");
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_crc_verify: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,141 @@
+// Measures the cost of protecting one read of a shared pointer while a writer
+// keeps replacing it: with an EpochDomain guard, with a shared reference count
+// (one fetch_add and one fetch_sub per read, as per-segment pin counts did),
+// and unprotected as a floor. Each reader loop is a separate noinline function
+// so its code can be inspected. On x86-64 the only lock-prefixed instruction
+// in the epoch loop is the seq_cst fence, which GCC emits as a locked OR on
+// the thread's own stack; the refcount loop's lock add and sub hit the shared
+// counter:
+//
+//   objdump -dC --no-show-raw-insn bench_epoch_read_path | awk '/<epoch_reads\(/,/ret/' | grep lock
+//
+//   bench_epoch_read_path [--readers 2] [--reads 5000000] [--swaps 100000]
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "ringbuff_epoch.hpp"
+
+struct Node {
+    uint64_t value;
+};
+
+std::atomic<Node*> shared_node{nullptr};
+std::atomic<uint64_t> shared_refs{0};
+
+__attribute__((noinline)) uint64_t epoch_reads(EpochDomain& domain, size_t reads) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < reads; ++i) {
+        const EpochDomain::Guard guard = domain.pin();
+        sum += shared_node.load(std::memory_order_acquire)->value;
+    }
+    return sum;
+}
+
+__attribute__((noinline)) uint64_t refcount_reads(size_t reads) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < reads; ++i) {
+        shared_refs.fetch_add(1, std::memory_order_acq_rel);
+        sum += shared_node.load(std::memory_order_acquire)->value;
+        shared_refs.fetch_sub(1, std::memory_order_release);
+    }
+    return sum;
+}
+
+__attribute__((noinline)) uint64_t unprotected_reads(size_t reads) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < reads; ++i) {
+        sum += shared_node.load(std::memory_order_acquire)->value;
+    }
+    return sum;
+}
+
+namespace {
+
+enum class Mode { Epoch, Refcount, Unprotected };
+
+const char* mode_name(Mode mode) {
+    switch (mode) {
+        case Mode::Epoch: return "epoch";
+        case Mode::Refcount: return "refcount";
+        case Mode::Unprotected: return "unprotected";
+    }
+    return "unknown";
+}
+
+// Runs the readers against a writer that swaps the node `swaps` times.
+// Only the epoch mode frees replaced nodes while readers run; the other modes
+// keep them until the readers are done, since they do not protect them.
+void run(Mode mode, size_t readers, size_t reads, size_t swaps) {
+    EpochDomain domain(readers + 2);
+    std::vector<Node*> parked;
+    shared_node.store(new Node{1});
+
+    std::atomic<size_t> done{0};
+    std::vector<double> ns(readers);
+    std::vector<std::thread> threads;
+    for (size_t r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r] {
+            const bench::Stopwatch watch;
+            uint64_t sum = 0;
+            switch (mode) {
+                case Mode::Epoch: sum = epoch_reads(domain, reads); break;
+                case Mode::Refcount: sum = refcount_reads(reads); break;
+                case Mode::Unprotected: sum = unprotected_reads(reads); break;
+            }
+            ns[r] = watch.ns();
+            bench::keep(sum);
+            done.fetch_add(1);
+        });
+    }
+    for (size_t i = 0; i < swaps && done.load() < readers; ++i) {
+        Node* old = shared_node.exchange(new Node{i + 2});
+        if (mode == Mode::Epoch) {
+            domain.retire([old] { delete old; });
+        } else {
+            parked.push_back(old);
+        }
+        std::this_thread::yield();
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    domain.collect();
+    delete shared_node.exchange(nullptr);
+    for (Node* node : parked) {
+        delete node;
+    }
+
+    double total = 0;
+    for (const double value : ns) {
+        total += value;
+    }
+    std::printf("mode=%s readers=%zu reads=%zu ns_per_read=%.2f\n", mode_name(mode), readers, reads,
+                total / static_cast<double>(readers * reads));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const size_t readers = bench::flag_size(argc, argv, "readers", 2);
+        const size_t reads = bench::flag_size(argc, argv, "reads", 5000000);
+        const size_t swaps = bench::flag_size(argc, argv, "swaps", 100000);
+        if (readers == 0 || reads == 0) {
+            std::fprintf(stderr, "bench_epoch_read_path: need at least one reader and one read\n");
+            return 1;
+        }
+        for (const Mode mode : {Mode::Unprotected, Mode::Epoch, Mode::Refcount}) {
+            run(mode, readers, reads, swaps);
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_epoch_read_path: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,188 @@
+// Checks EwmaBank against a scalar EWMA computed one average and one sample at
+// a time, and times both update paths. Samples are pushed through a
+// RingBuffer and drained with pop_bulk(), whose output is also checked
+// against what was pushed. The timestamped path runs with regular intervals,
+// runs of equal intervals, and a different interval for every sample; it is
+// also timed with one-sample calls, as a caller without batches would make.
+//
+//   bench_ewma [--samples 1000000] [--averages 64] [--batch 1024] [--tolerance 1e-9]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "ringbuff.hpp"
+#include "ringbuff_ewma.hpp"
+
+namespace {
+
+uint64_t next(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// Alphas spread log-uniformly from 0.5 down to 1e-4.
+std::vector<double> make_alphas(size_t count) {
+    std::vector<double> alphas(count);
+    for (size_t i = 0; i < count; ++i) {
+        alphas[i] = 0.5 * std::pow(2e-4, static_cast<double>(i) / static_cast<double>(std::max<size_t>(count - 1, 1)));
+    }
+    return alphas;
+}
+
+// Timestamps for the three interval patterns.
+std::vector<double> make_timestamps(size_t count, const std::string& pattern) {
+    std::vector<double> timestamps(count);
+    uint64_t state = 0x2545f4914f6cdd1dULL;
+    double time = 0;
+    double dt = 1;
+    for (size_t i = 0; i < count; ++i) {
+        if (pattern == "runs" && next(state) % 32 == 0) {
+            // Intervals of 1 to 4 units, changing every 32 samples on average.
+            dt = static_cast<double>(1 + next(state) % 4);
+        } else if (pattern == "jitter") {
+            dt = 0.5 + static_cast<double>(next(state) % 1000) / 1000.0;
+        }
+        time += dt;
+        timestamps[i] = time;
+    }
+    return timestamps;
+}
+
+// v <- v + a * (x - v), one average and one sample at a time. With
+// timestamps, a is 1 - (1 - alpha)^dt. The first sample sets every average.
+std::vector<double> scalar_ewma(const std::vector<double>& alphas, const std::vector<double>& samples,
+                                const std::vector<double>* timestamps) {
+    std::vector<double> values(alphas.size(), samples.front());
+    for (size_t a = 0; a < alphas.size(); ++a) {
+        double v = values[a];
+        for (size_t s = 1; s < samples.size(); ++s) {
+            const double weight =
+                timestamps == nullptr ? alphas[a]
+                                      : 1.0 - std::pow(1.0 - alphas[a], (*timestamps)[s] - (*timestamps)[s - 1]);
+            v += weight * (samples[s] - v);
+        }
+        values[a] = v;
+    }
+    return values;
+}
+
+double max_error(std::span<const double> got, const std::vector<double>& want) {
+    double worst = 0;
+    for (size_t i = 0; i < want.size(); ++i) {
+        worst = std::max(worst, std::fabs(got[i] - want[i]) / std::max(std::fabs(want[i]), 1.0));
+    }
+    return worst;
+}
+
+void report(const char* method, const char* pattern, size_t samples, size_t averages, double ns, double error,
+            double tolerance, bool& ok) {
+    const bool passed = error <= tolerance;
+    std::printf("method=%s intervals=%s samples=%zu averages=%zu ns_per_sample=%.1f max_rel_error=%.2e %s\n", method,
+                pattern, samples, averages, ns / static_cast<double>(samples), error, passed ? "ok" : "FAILED");
+    ok &= passed;
+}
+
+// Pushes samples (and timestamps, if given) through rings, drains them with
+// pop_bulk() in batches and feeds each batch to the bank. Returns false if a
+// drained batch differs from what was pushed.
+bool feed_through_ring(EwmaBank& bank, const std::vector<double>& samples, const std::vector<double>* timestamps,
+                       size_t batch, double& ns) {
+    RingBuffer<double> sample_ring(4 * batch);
+    RingBuffer<double> time_ring(4 * batch);
+    std::vector<double> sample_batch(batch);
+    std::vector<double> time_batch(batch);
+    bool same = true;
+    ns = 0;
+    for (size_t at = 0; at < samples.size();) {
+        // Fill to a wrapped state with 3 batches, then drain them.
+        const size_t end = std::min(samples.size(), at + 3 * batch);
+        for (size_t i = at; i < end; ++i) {
+            sample_ring.push(samples[i]);
+            if (timestamps != nullptr) {
+                time_ring.push((*timestamps)[i]);
+            }
+        }
+        const bench::Stopwatch watch;
+        size_t drained = at;
+        while (size_t n = sample_ring.pop_bulk(sample_batch)) {
+            if (timestamps != nullptr) {
+                time_ring.pop_bulk(std::span<double>(time_batch).first(n));
+                bank.update(std::span<const double>(sample_batch.data(), n),
+                            std::span<const double>(time_batch.data(), n));
+            } else {
+                bank.update(std::span<const double>(sample_batch.data(), n));
+            }
+            same &= std::equal(sample_batch.begin(), sample_batch.begin() + static_cast<std::ptrdiff_t>(n),
+                               samples.begin() + static_cast<std::ptrdiff_t>(drained));
+            drained += n;
+        }
+        ns += watch.ns();
+        at = end;
+    }
+    return same;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const size_t count = bench::flag_size(argc, argv, "samples", 1000000);
+        const size_t averages = bench::flag_size(argc, argv, "averages", 64);
+        const size_t batch = bench::flag_size(argc, argv, "batch", 1024);
+        const double tolerance = bench::flag_double(argc, argv, "tolerance", 1e-9);
+        if (count < 2 || averages == 0 || batch == 0) {
+            std::fprintf(stderr, "bench_ewma: need --samples > 1, --averages and --batch > 0\n");
+            return 1;
+        }
+        const std::vector<double> alphas = make_alphas(averages);
+        std::vector<double> samples(count);
+        uint64_t state = 0x9e3779b97f4a7c15ULL;
+        for (double& sample : samples) {
+            sample = static_cast<double>(next(state) % 100000) / 100.0;
+        }
+        bool ok = true;
+
+        const bench::Stopwatch scalar_watch;
+        std::vector<double> want = scalar_ewma(alphas, samples, nullptr);
+        report("scalar", "none", count, averages, scalar_watch.ns(), 0, tolerance, ok);
+
+        EwmaBank bank(alphas);
+        double ns = 0;
+        bool drained_ok = feed_through_ring(bank, samples, nullptr, batch, ns);
+        report("update", "none", count, averages, ns, max_error(bank.values(), want), tolerance, ok);
+
+        for (const char* pattern : {"regular", "runs", "jitter"}) {
+            const std::vector<double> timestamps = make_timestamps(count, pattern);
+            const bench::Stopwatch timed_scalar_watch;
+            want = scalar_ewma(alphas, samples, &timestamps);
+            report("scalar", pattern, count, averages, timed_scalar_watch.ns(), 0, tolerance, ok);
+
+            EwmaBank timed(alphas);
+            drained_ok &= feed_through_ring(timed, samples, &timestamps, batch, ns);
+            report("update_timed", pattern, count, averages, ns, max_error(timed.values(), want), tolerance, ok);
+
+            EwmaBank single(alphas);
+            const bench::Stopwatch single_watch;
+            for (size_t i = 0; i < count; ++i) {
+                single.update(std::span<const double>(&samples[i], 1), std::span<const double>(&timestamps[i], 1));
+            }
+            report("update_timed_one_by_one", pattern, count, averages, single_watch.ns(),
+                   max_error(single.values(), want), tolerance, ok);
+        }
+
+        std::printf("check pop_bulk_batches_match_pushes %s\n", drained_ok ? "ok" : "MISMATCH");
+        return ok && drained_ok ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_ewma: %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,154 @@
+// Checks FirFilterRing::push() and process() against a direct convolution in
+// double precision, with every kernel this CPU supports, and times both. Tap
+// counts 63, 64 and 65 straddle the vector widths; 256 is a typical long
+// filter. process() is timed with fixed blocks and checked again with blocks
+// of random length. Errors are relative to the sum of |taps[k] * x[n - k]|,
+// which bounds every output.
+//
+//   bench_fir [--samples 1000000] [--block 1024] [--tolerance 1e-5]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <span>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "ringbuff_fir.hpp"
+
+namespace {
+
+std::vector<float> random_floats(size_t count, uint64_t state, float scale) {
+    std::vector<float> values(count);
+    for (float& value : values) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        value = static_cast<float>((static_cast<double>(state % 20001) / 10000.0 - 1.0) * scale);
+    }
+    return values;
+}
+
+// The exact outputs, and the error bound for each, in double precision.
+struct Reference {
+    std::vector<double> outputs;
+    std::vector<double> scales;
+};
+
+Reference convolve(const std::vector<float>& taps, const std::vector<float>& samples) {
+    Reference reference;
+    reference.outputs.resize(samples.size());
+    reference.scales.resize(samples.size());
+    for (size_t n = 0; n < samples.size(); ++n) {
+        double sum = 0;
+        double scale = 0;
+        for (size_t k = 0; k < taps.size() && k <= n; ++k) {
+            const double term = static_cast<double>(taps[k]) * samples[n - k];
+            sum += term;
+            scale += std::fabs(term);
+        }
+        reference.outputs[n] = sum;
+        reference.scales[n] = std::max(scale, 1e-30);
+    }
+    return reference;
+}
+
+double max_error(const std::vector<float>& outputs, const Reference& reference) {
+    double worst = 0;
+    for (size_t n = 0; n < outputs.size(); ++n) {
+        worst = std::max(worst, std::fabs(outputs[n] - reference.outputs[n]) / reference.scales[n]);
+    }
+    return worst;
+}
+
+// Filters samples through process() in blocks whose lengths come from next_length().
+template <typename NextLength>
+std::vector<float> process_blocks(FirFilterRing& filter, const std::vector<float>& samples, NextLength&& next_length) {
+    std::vector<float> outputs(samples.size());
+    for (size_t at = 0; at < samples.size();) {
+        const size_t length = std::min(next_length(), samples.size() - at);
+        filter.process(std::span<const float>(samples).subspan(at, length),
+                       std::span<float>(outputs).subspan(at, length));
+        at += length;
+    }
+    return outputs;
+}
+
+// Prints one result line; ns is 0 for checks that are not timed.
+bool report(const char* set, size_t taps, const char* method, double ns, size_t samples, double error,
+            double tolerance) {
+    const bool ok = error <= tolerance;
+    if (ns > 0) {
+        std::printf("set=%s taps=%zu method=%s ns_per_sample=%.2f max_rel_error=%.2e %s\n", set, taps, method,
+                    ns / static_cast<double>(samples), error, ok ? "ok" : "FAILED");
+    } else {
+        std::printf("set=%s taps=%zu method=%s max_rel_error=%.2e %s\n", set, taps, method, error,
+                    ok ? "ok" : "FAILED");
+    }
+    return ok;
+}
+
+// Runs every check and timing for one kernel and tap count.
+bool run(const char* set, const std::vector<float>& taps, const std::vector<float>& samples,
+         const Reference& reference, size_t block, double tolerance) {
+    bool ok = true;
+
+    FirFilterRing pushed(taps, set);
+    std::vector<float> outputs(samples.size());
+    const bench::Stopwatch push_watch;
+    for (size_t n = 0; n < samples.size(); ++n) {
+        outputs[n] = pushed.push(samples[n]);
+    }
+    const double push_ns = push_watch.ns();
+    ok &= report(set, taps.size(), "push", push_ns, samples.size(), max_error(outputs, reference), tolerance);
+
+    FirFilterRing blocked(taps, set);
+    const bench::Stopwatch process_watch;
+    outputs = process_blocks(blocked, samples, [&] { return block; });
+    const double process_ns = process_watch.ns();
+    ok &= report(set, taps.size(), "process", process_ns, samples.size(), max_error(outputs, reference), tolerance);
+
+    // Random lengths from 1 to 2 * block cover blocks shorter than the taps
+    // and lengths that are not multiples of the vector width.
+    FirFilterRing ragged(taps, set);
+    uint64_t state = 0x2545f4914f6cdd1dULL;
+    outputs = process_blocks(ragged, samples, [&] {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return 1 + static_cast<size_t>(state % (2 * block));
+    });
+    ok &= report(set, taps.size(), "process_ragged", 0, samples.size(), max_error(outputs, reference), tolerance);
+    return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const size_t count = bench::flag_size(argc, argv, "samples", 1000000);
+        const size_t block = bench::flag_size(argc, argv, "block", 1024);
+        const double tolerance = bench::flag_double(argc, argv, "tolerance", 1e-5);
+        if (count == 0 || block == 0) {
+            std::fprintf(stderr, "bench_fir: need --samples and --block > 0\n");
+            return 1;
+        }
+        const std::vector<float> samples = random_floats(count, 0x9e3779b97f4a7c15ULL, 1.0f);
+
+        bool ok = true;
+        for (const size_t tap_count : {63, 64, 65, 256}) {
+            const std::vector<float> taps =
+                random_floats(tap_count, 0xbf58476d1ce4e5b9ULL + tap_count, 1.0f / static_cast<float>(tap_count));
+            const Reference reference = convolve(taps, samples);
+            for (const char* set : FirFilterRing::supported_instruction_sets()) {
+                ok &= run(set, taps, samples, reference, block, tolerance);
+            }
+        }
+        return ok ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_fir: %s\n", e.what());
+        return 1;
+    }
+}
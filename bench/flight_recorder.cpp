@@ -0,0 +1,213 @@
+// Measures FlightRecorder::record() from several threads, dumps the recorder,
+// converts the dump with trace_to_chrome_json() and checks that every kept
+// event made it into the JSON. Rounds of short-lived threads then check that
+// exited threads' rings are reused rather than dropping events. Forked
+// children record, install the crash handler and abort, or overflow a
+// thread's stack; the parent converts the dumps they left behind.
+// Open the JSON files in chrome://tracing or https://ui.perfetto.dev.
+//
+//   bench_flight_recorder [--threads 4] [--events 1000000] [--capacity 16384] [--out /tmp/bench_trace]
+
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <barrier>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "ringbuff_trace.hpp"
+
+namespace {
+
+constexpr uint16_t span_id = 1;
+constexpr uint16_t tick_id = 2;
+
+// CPU time of the calling thread, so threads sharing a core are not charged
+// for each other's time slices.
+double thread_cpu_ns() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) * 1e9 + static_cast<double>(ts.tv_nsec);
+}
+
+// Converts a dump to JSON at json_path and returns the number of events in it.
+size_t convert(const std::string& dump_path, const std::string& json_path) {
+    std::ifstream dump(dump_path, std::ios::binary);
+    if (!dump) {
+        throw std::runtime_error("cannot open " + dump_path);
+    }
+    std::ostringstream json;
+    trace_to_chrome_json(dump, json);
+    const std::string text = json.str();
+    std::ofstream(json_path) << text;
+
+    size_t events = 0;
+    for (size_t at = text.find("\"ph\":"); at != std::string::npos; at = text.find("\"ph\":", at + 1)) {
+        ++events;
+    }
+    return events;
+}
+
+// Recurses until the stack runs out.
+[[gnu::noinline]] size_t overflow(size_t depth) {
+    volatile char frame[4096];
+    frame[0] = static_cast<char>(depth);
+    if (depth == SIZE_MAX) {
+        return 0;
+    }
+    return overflow(depth + 1) + static_cast<size_t>(frame[0]);
+}
+
+// Runs `rounds` rounds of `threads` threads that each record `events` events
+// and exit once the whole round has recorded, on a recorder with one ring per
+// thread of a round. Returns the number of events in the final dump, which
+// should hold the last round only.
+size_t churn(const std::string& out, size_t threads, size_t rounds, size_t events, uint64_t& dropped) {
+    FlightRecorder recorder(events, threads);
+    for (size_t round = 0; round < rounds; ++round) {
+        std::barrier recorded(static_cast<std::ptrdiff_t>(threads));
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, round] {
+                for (size_t i = 0; i < events; ++i) {
+                    recorder.record(tick_id, TracePhase::Instant, static_cast<uint32_t>(round));
+                }
+                recorded.arrive_and_wait();
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+    dropped = recorder.dropped();
+    const std::string dump_path = out + "-churn.bin";
+    if (!recorder.dump(dump_path.c_str())) {
+        throw std::runtime_error("cannot write " + dump_path);
+    }
+    return convert(dump_path, out + "-churn.json");
+}
+
+// Records 100 events from a forked child with the crash handler installed,
+// then aborts or, with stack_overflow, records from a thread that overflows
+// its stack. Returns the number of events in the converted crash dump.
+size_t crash_dump(const std::string& out, const char* name, size_t capacity, bool stack_overflow) {
+    const std::string dump_path = out + "-" + name + ".bin";
+    std::remove(dump_path.c_str());
+    std::fflush(stdout);  // Or the child may print the parent's buffered lines again
+    const pid_t child = fork();
+    if (child < 0) {
+        throw std::runtime_error("fork failed");
+    }
+    if (child == 0) {
+        FlightRecorder recorder(capacity, 2);
+        recorder.name_event(tick_id, "tick");
+        recorder.install_crash_handler(dump_path);
+        const auto record = [&] {
+            for (uint32_t i = 0; i < 100; ++i) {
+                recorder.record(tick_id, TracePhase::Instant, i);
+            }
+        };
+        if (stack_overflow) {
+            std::thread([&] {
+                record();
+                bench::keep(overflow(0));
+            }).join();
+        }
+        record();
+        std::abort();
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    const int expected = stack_overflow ? SIGSEGV : SIGABRT;
+    if (!WIFSIGNALED(status) || WTERMSIG(status) != expected) {
+        throw std::runtime_error(std::string(name) + " child did not die of " + (stack_overflow ? "SIGSEGV" : "SIGABRT"));
+    }
+    return convert(dump_path, out + "-" + name + ".json");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const size_t threads = bench::flag_size(argc, argv, "threads", 4);
+        const size_t events = bench::flag_size(argc, argv, "events", 1000000);
+        const size_t capacity = bench::flag_size(argc, argv, "capacity", 16384);
+        const std::string out = bench::flag(argc, argv, "out", "/tmp/bench_trace");
+        if (threads == 0 || events < 2 || capacity == 0) {
+            std::fprintf(stderr, "bench_flight_recorder: need threads, at least two events and a capacity\n");
+            return 1;
+        }
+
+        FlightRecorder recorder(capacity, threads);
+        recorder.name_event(span_id, "span");
+        std::vector<double> ns(threads);
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                const double start = thread_cpu_ns();
+                for (size_t i = 0; i < events / 2; ++i) {
+                    const TraceScope scope(recorder, span_id, static_cast<uint32_t>(i));
+                }
+                ns[t] = thread_cpu_ns() - start;
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        double total = 0;
+        for (const double value : ns) {
+            total += value;
+        }
+        const size_t recorded = events / 2 * 2;
+        std::printf("record threads=%zu events_per_thread=%zu cpu_ns_per_event=%.2f\n", threads, recorded,
+                    total / static_cast<double>(threads * recorded));
+
+        const std::string dump_path = out + ".bin";
+        const bench::Stopwatch dump_watch;
+        if (!recorder.dump(dump_path.c_str())) {
+            std::fprintf(stderr, "bench_flight_recorder: cannot write %s\n", dump_path.c_str());
+            return 1;
+        }
+        const double dump_ns = dump_watch.ns();
+        const size_t kept = convert(dump_path, out + ".json");
+        const size_t expected = threads * (recorded < capacity ? recorded : capacity);
+        std::printf("dump events=%zu expected=%zu dump_us=%.1f json=%s.json\n", kept, expected, dump_ns / 1e3,
+                    out.c_str());
+        if (kept != expected) {
+            std::fprintf(stderr, "bench_flight_recorder: the JSON lost events\n");
+            return 1;
+        }
+
+        uint64_t dropped = 0;
+        const size_t churned = churn(out, threads, 8, 100, dropped);
+        std::printf("churn threads=%zu rounds=8 events=%zu expected=%zu dropped=%llu\n", threads, churned,
+                    threads * 100, static_cast<unsigned long long>(dropped));
+        if (churned != threads * 100 || dropped != 0) {
+            std::fprintf(stderr, "bench_flight_recorder: exited threads' rings were not reused\n");
+            return 1;
+        }
+
+        const size_t crashed = crash_dump(out, "crash", capacity, false);
+        std::printf("crash events=%zu expected=100 json=%s-crash.json\n", crashed, out.c_str());
+        const size_t overflowed = crash_dump(out, "overflow", capacity, true);
+        std::printf("stack_overflow events=%zu expected=100 json=%s-overflow.json\n", overflowed, out.c_str());
+        if (crashed != 100 || overflowed != 100) {
+            std::fprintf(stderr, "bench_flight_recorder: a crash dump lost events\n");
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_flight_recorder: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,86 @@
+// Sweeps every ordered pair of CPUs and prints the one-way hand-off latency
+// matrix, the mean latency per sharing level and the pairs place_pairs()
+// would choose.
+//
+//   bench_handoff_matrix [--cpus 0-7] [--round-trips 100000] [--pairs 4]
+
+#include <cstdio>
+#include <exception>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "ringbuff_affinity.hpp"
+
+namespace {
+
+const char* sharing_name(CpuSharing sharing) {
+    switch (sharing) {
+        case CpuSharing::Same: return "same";
+        case CpuSharing::Core: return "smt";
+        case CpuSharing::L2: return "l2";
+        case CpuSharing::L3: return "l3";
+        case CpuSharing::Package: return "package";
+        case CpuSharing::Node: return "node";
+        case CpuSharing::Remote: return "remote";
+    }
+    return "unknown";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const CpuTopology topology = CpuTopology::discover();
+        std::vector<int> cpus;
+        const std::string list = bench::flag(argc, argv, "cpus", "");
+        if (list.empty()) {
+            for (const CpuInfo& info : topology.cpus()) {
+                cpus.push_back(info.cpu);
+            }
+        } else {
+            cpus = parse_cpu_list(list);
+        }
+        const size_t round_trips = bench::flag_size(argc, argv, "round-trips", 100000);
+
+        const HandoffMatrix matrix = measure_handoff_matrix(cpus, round_trips);
+        std::printf("one-way hand-off latency, ns (row = producer, column = consumer)\n%6s", "");
+        for (const int cpu : cpus) {
+            std::printf("%8d", cpu);
+        }
+        std::printf("\n");
+        for (size_t i = 0; i < cpus.size(); ++i) {
+            std::printf("%6d", cpus[i]);
+            for (size_t j = 0; j < cpus.size(); ++j) {
+                std::printf("%8.1f", matrix.at(i, j));
+            }
+            std::printf("\n");
+        }
+
+        std::map<CpuSharing, std::pair<double, size_t>> by_level;
+        for (size_t i = 0; i < cpus.size(); ++i) {
+            for (size_t j = 0; j < cpus.size(); ++j) {
+                if (cpus[i] != cpus[j]) {
+                    auto& [sum, count] = by_level[topology.sharing(cpus[i], cpus[j])];
+                    sum += matrix.at(i, j);
+                    ++count;
+                }
+            }
+        }
+        for (const auto& [level, totals] : by_level) {
+            std::printf("sharing=%s pairs=%zu mean_ns=%.1f\n", sharing_name(level), totals.second,
+                        totals.first / static_cast<double>(totals.second));
+        }
+
+        const size_t pairs = bench::flag_size(argc, argv, "pairs", cpus.size() / 2);
+        for (const auto& [producer, consumer] : topology.place_pairs(pairs)) {
+            std::printf("placed producer=%d consumer=%d sharing=%s\n", producer, consumer,
+                        sharing_name(topology.sharing(producer, consumer)));
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_handoff_matrix: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+// Compares a Journal's group commit with one commit per record. In group mode
+// producers append freely and a final flush() waits for the tail; in
+// per-record mode every append is followed by flush(), which is one fdatasync
+// per record. Each line reports the throughput and how many batches the
+// writer committed, each with one fdatasync (plus one per segment rotation).
+//
+//   bench_journal_commit [--dir /tmp] [--records 20000] [--bytes 128] [--producers 2]
+//                        [--per-record-records 500]
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "ringbuff_journal.hpp"
+
+namespace {
+
+// A fresh directory under `parent`, removed again on destruction.
+class ScratchDir {
+public:
+    explicit ScratchDir(const std::string& parent) {
+        std::string pattern = parent + "/bench_journal_XXXXXX";
+        if (mkdtemp(pattern.data()) == nullptr) {
+            throw std::runtime_error("cannot create a directory under " + parent);
+        }
+        path_ = pattern;
+    }
+
+    ~ScratchDir() {
+        std::error_code ignored;
+        std::filesystem::remove_all(path_, ignored);
+    }
+
+    ScratchDir(const ScratchDir&) = delete;
+    ScratchDir& operator=(const ScratchDir&) = delete;
+
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+};
+
+void report(const char* mode, size_t producers, size_t records, size_t bytes, double ns, uint64_t batches) {
+    std::printf("mode=%s producers=%zu records=%zu bytes=%zu records_per_s=%.0f us_per_record=%.2f batches=%llu "
+                "records_per_batch=%.1f\n",
+                mode, producers, records, bytes, static_cast<double>(records) * 1e9 / ns,
+                ns / 1e3 / static_cast<double>(records), static_cast<unsigned long long>(batches),
+                static_cast<double>(records) / static_cast<double>(batches == 0 ? 1 : batches));
+}
+
+void run_group(const std::string& parent, size_t producers, size_t records, size_t bytes) {
+    const ScratchDir dir(parent);
+    std::atomic<uint64_t> batches{0};
+    JournalOptions options;
+    options.directory = dir.path();
+    options.on_durable = [&](uint64_t) { batches.fetch_add(1, std::memory_order_relaxed); };
+    Journal journal(options);
+
+    const std::vector<std::byte> payload(bytes, std::byte{0x5a});
+    const size_t per_producer = records / producers;
+    const bench::Stopwatch watch;
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&] {
+            for (size_t i = 0; i < per_producer; ++i) {
+                journal.append(payload);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    journal.flush();
+    report("group", producers, per_producer * producers, bytes, watch.ns(), batches.load());
+}
+
+void run_per_record(const std::string& parent, size_t records, size_t bytes) {
+    const ScratchDir dir(parent);
+    std::atomic<uint64_t> batches{0};
+    JournalOptions options;
+    options.directory = dir.path();
+    options.on_durable = [&](uint64_t) { batches.fetch_add(1, std::memory_order_relaxed); };
+    Journal journal(options);
+
+    const std::vector<std::byte> payload(bytes, std::byte{0x5a});
+    const bench::Stopwatch watch;
+    for (size_t i = 0; i < records; ++i) {
+        journal.append(payload);
+        journal.flush();
+    }
+    report("per_record", 1, records, bytes, watch.ns(), batches.load());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const std::string parent = bench::flag(argc, argv, "dir", "/tmp");
+        const size_t records = bench::flag_size(argc, argv, "records", 20000);
+        const size_t bytes = bench::flag_size(argc, argv, "bytes", 128);
+        const size_t producers = bench::flag_size(argc, argv, "producers", 2);
+        const size_t per_record = bench::flag_size(argc, argv, "per-record-records", 500);
+        if (producers == 0 || records < producers || per_record == 0) {
+            std::fprintf(stderr, "bench_journal_commit: need at least one producer and one record each\n");
+            return 1;
+        }
+        run_group(parent, producers, records, bytes);
+        run_per_record(parent, per_record, bytes);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_journal_commit: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,134 @@
+// Measures the LZ4 block codec on log-like text and on random bytes, in
+// 64 KiB blocks as checkpoints use it, then times a save_checkpoint() /
+// load_checkpoint() round trip of a ring of log text with and without
+// compression. Every decompressed block and restored ring is compared with
+// its source.
+//
+//   bench_lz4_codec [--mb 16] [--passes 4] [--block 65536]
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "ringbuff_checkpoint.hpp"
+#include "ringbuff_lz4.hpp"
+
+namespace {
+
+std::vector<unsigned char> log_text(size_t bytes) {
+    std::string text;
+    uint64_t state = 42;
+    auto next = [&state] {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<unsigned>(state >> 33);
+    };
+    while (text.size() < bytes) {
+        text += "2026-10-18T12:00:" + std::to_string(next() % 60) +
+                " level=info msg=\"request served\" latency_us=" + std::to_string(next() % 5000) + "\n";
+    }
+    return std::vector<unsigned char>(text.begin(), text.begin() + static_cast<std::ptrdiff_t>(bytes));
+}
+
+std::vector<unsigned char> random_bytes(size_t bytes) {
+    std::vector<unsigned char> data(bytes);
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    for (unsigned char& byte : data) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        byte = static_cast<unsigned char>(state);
+    }
+    return data;
+}
+
+// Returns false if a block does not round-trip.
+bool run_codec(const char* name, const std::vector<unsigned char>& data, size_t block, size_t passes) {
+    const size_t blocks = data.size() / block;
+    std::vector<std::vector<unsigned char>> packed(blocks, std::vector<unsigned char>(lz4_compress_bound(block)));
+    std::vector<size_t> sizes(blocks);
+
+    const bench::Stopwatch compress_watch;
+    for (size_t pass = 0; pass < passes; ++pass) {
+        for (size_t i = 0; i < blocks; ++i) {
+            sizes[i] = lz4_compress(data.data() + i * block, block, packed[i].data(), packed[i].size());
+        }
+    }
+    const double compress_ns = compress_watch.ns();
+
+    std::vector<unsigned char> out(block);
+    size_t stored = 0;
+    bool ok = true;
+    const bench::Stopwatch decompress_watch;
+    for (size_t pass = 0; pass < passes; ++pass) {
+        for (size_t i = 0; i < blocks; ++i) {
+            ok &= lz4_decompress(packed[i].data(), sizes[i], out.data(), out.size()) == block;
+            if (pass == 0) {
+                ok &= std::memcmp(out.data(), data.data() + i * block, block) == 0;
+                stored += sizes[i];
+            }
+        }
+    }
+    const double decompress_ns = decompress_watch.ns();
+
+    const double bytes = static_cast<double>(blocks * block * passes);
+    std::printf("data=%s block=%zu ratio=%.3f compress_gb_per_s=%.2f decompress_gb_per_s=%.2f roundtrip=%s\n", name,
+                block, static_cast<double>(stored) / static_cast<double>(blocks * block), bytes / compress_ns,
+                bytes / decompress_ns, ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+// Returns false if the restored ring differs from the saved one.
+bool run_checkpoint(const std::vector<unsigned char>& data, bool compress) {
+    RingBuffer<unsigned char> ring(data.size());
+    for (const unsigned char byte : data) {
+        ring.push(byte);
+    }
+    CheckpointOptions options;
+    options.compress = compress;
+
+    std::stringstream stream;
+    const bench::Stopwatch save_watch;
+    save_checkpoint(ring, stream, options);
+    const double save_ns = save_watch.ns();
+    const size_t stored = stream.str().size();
+
+    const bench::Stopwatch load_watch;
+    const RingBuffer<unsigned char> restored = load_checkpoint<unsigned char>(stream);
+    const double load_ns = load_watch.ns();
+
+    const auto [first, second] = restored.segments();
+    const bool ok = restored.size() == data.size() && second.empty() &&
+                    std::memcmp(first.data(), data.data(), data.size()) == 0;
+    std::printf("checkpoint compress=%d bytes=%zu stored=%zu save_gb_per_s=%.2f load_gb_per_s=%.2f restore=%s\n",
+                compress ? 1 : 0, data.size(), stored, static_cast<double>(data.size()) / save_ns,
+                static_cast<double>(data.size()) / load_ns, ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const size_t bytes = bench::flag_size(argc, argv, "mb", 16) << 20;
+        const size_t passes = bench::flag_size(argc, argv, "passes", 4);
+        const size_t block = bench::flag_size(argc, argv, "block", 65536);
+        if (block == 0 || passes == 0 || bytes < block) {
+            std::fprintf(stderr, "bench_lz4_codec: need --passes > 0 and --mb of at least one --block\n");
+            return 1;
+        }
+        const std::vector<unsigned char> text = log_text(bytes);
+        bool ok = run_codec("log", text, block, passes);
+        ok &= run_codec("random", random_bytes(bytes), block, passes);
+        ok &= run_checkpoint(text, true);
+        ok &= run_checkpoint(text, false);
+        return ok ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_lz4_codec: %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,119 @@
+// Measures the concurrent queues and EpochDomain::pin() with whatever memory
+// orders ringbuff_memory_order.hpp selects. The build compiles this driver
+// twice, as bench_memory_order (minimal orders) and bench_memory_order_seqcst
+// (RING_STRICT_SEQCST); run both on the same machine and compare the lines.
+//
+//   bench_memory_order [--ops 2000000] [--threads 2] [--capacity 1024]
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "ringbuff_epoch.hpp"
+#include "ringbuff_memory_order.hpp"
+#include "ringbuff_mpmc.hpp"
+#include "ringbuff_tagged.hpp"
+#include "ringbuff_unbounded.hpp"
+
+namespace {
+
+const char* mode() {
+    return ring_order::strict ? "seq_cst" : "minimal";
+}
+
+// One thread alternating push and pop: the uncontended cost of each order.
+template <typename Queue>
+void run_single(const char* name, Queue& queue, size_t ops) {
+    uint64_t sum = 0;
+    uint64_t value = 0;
+    const bench::Stopwatch watch;
+    for (size_t i = 0; i < ops; ++i) {
+        queue.try_push(static_cast<uint64_t>(i));
+        queue.try_pop(value);
+        sum += value;
+    }
+    const double ns = watch.ns();
+    bench::keep(sum);
+    std::printf("orders=%s queue=%s threads=1 ns_per_push_pop=%.2f\n", mode(), name, ns / static_cast<double>(ops));
+}
+
+// Producers and consumers in equal numbers moving `ops` elements in total.
+template <typename Queue>
+void run_threads(const char* name, Queue& queue, size_t threads, size_t ops) {
+    const size_t per_thread = ops / threads;
+    std::atomic<size_t> consumed{0};
+    const bench::Stopwatch watch;
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (size_t i = 0; i < per_thread; ++i) {
+                while (!queue.try_push(static_cast<uint64_t>(i))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        workers.emplace_back([&] {
+            uint64_t value = 0;
+            while (consumed.load(std::memory_order_relaxed) < per_thread * threads) {
+                if (queue.try_pop(value)) {
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    const double ns = watch.ns();
+    std::printf("orders=%s queue=%s threads=%zu+%zu ns_per_element=%.2f\n", mode(), name, threads, threads,
+                ns / static_cast<double>(per_thread * threads));
+}
+
+void run_pin(size_t ops) {
+    EpochDomain domain;
+    const bench::Stopwatch watch;
+    for (size_t i = 0; i < ops; ++i) {
+        const EpochDomain::Guard guard = domain.pin();
+    }
+    std::printf("orders=%s epoch_pin ns_per_pin=%.2f\n", mode(), watch.ns() / static_cast<double>(ops));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const size_t ops = bench::flag_size(argc, argv, "ops", 2000000);
+        const size_t threads = bench::flag_size(argc, argv, "threads", 2);
+        const size_t capacity = bench::flag_size(argc, argv, "capacity", 1024);
+        if (ops < threads || threads == 0) {
+            std::fprintf(stderr, "bench_memory_order: need --threads > 0 and at least one op per thread\n");
+            return 1;
+        }
+        {
+            MpmcRingBuffer<uint64_t> queue(capacity);
+            run_single("mpmc", queue, ops);
+            run_threads("mpmc", queue, threads, ops);
+        }
+        {
+            TaggedRingBuffer<uint64_t> queue(capacity);
+            run_single("tagged", queue, ops);
+            run_threads("tagged", queue, threads, ops);
+        }
+        {
+            UnboundedRing<uint64_t> queue(capacity);
+            run_single("unbounded", queue, ops);
+            run_threads("unbounded", queue, threads, ops);
+        }
+        run_pin(ops);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_memory_order: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
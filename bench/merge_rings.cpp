@@ -0,0 +1,154 @@
+// Merges N timestamp-ordered rings of ticks three ways: MergedRingReader::pop(),
+// MergedRingReader::consume(), and a scan that polls every ring's front() for
+// each element. Ticks are dealt to the rings in runs of consecutive
+// timestamps, from a random ring each time. Timestamps are the global order,
+// so every merge must come out as 0, 1, 2, ...
+//
+//   bench_merge_rings [--ticks 1000000] [--rings 16,64] [--runs 1,32]
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "ringbuff_merge.hpp"
+
+namespace {
+
+struct Tick {
+    uint64_t ns;
+    uint64_t payload;
+};
+
+struct NsOf {
+    uint64_t operator()(const Tick& tick) const { return tick.ns; }
+};
+
+// Parses a comma-separated list of positive numbers.
+std::vector<size_t> parse_list(const std::string& text) {
+    std::vector<size_t> values;
+    for (const char* at = text.c_str(); *at != '\0';) {
+        char* end = nullptr;
+        const size_t value = std::strtoull(at, &end, 10);
+        if (end == at || value == 0) {
+            throw std::invalid_argument("bad list " + text);
+        }
+        values.push_back(value);
+        at = *end == ',' ? end + 1 : end;
+    }
+    return values;
+}
+
+// The ring each tick goes to: runs of `run` ticks, each to a random ring.
+std::vector<uint32_t> deal(size_t ticks, size_t rings, size_t run) {
+    std::vector<uint32_t> owner(ticks);
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < ticks; i += run) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        for (size_t j = i; j < ticks && j < i + run; ++j) {
+            owner[j] = static_cast<uint32_t>(state % rings);
+        }
+    }
+    return owner;
+}
+
+std::vector<std::unique_ptr<RingBuffer<Tick>>> fill(const std::vector<uint32_t>& owner, size_t rings) {
+    std::vector<size_t> sizes(rings);
+    for (const uint32_t ring : owner) {
+        ++sizes[ring];
+    }
+    std::vector<std::unique_ptr<RingBuffer<Tick>>> result;
+    for (size_t i = 0; i < rings; ++i) {
+        result.push_back(std::make_unique<RingBuffer<Tick>>(sizes[i] + 1));
+    }
+    for (size_t i = 0; i < owner.size(); ++i) {
+        result[owner[i]]->push(Tick{i, i * 7});
+    }
+    return result;
+}
+
+std::vector<RingBuffer<Tick>*> pointers(const std::vector<std::unique_ptr<RingBuffer<Tick>>>& rings) {
+    std::vector<RingBuffer<Tick>*> result;
+    for (const auto& ring : rings) {
+        result.push_back(ring.get());
+    }
+    return result;
+}
+
+// Runs one merge over freshly filled rings. `merge` calls its argument with
+// each tick in merged order. Returns false if the order is wrong.
+template <typename Merge>
+bool run(const char* method, const std::vector<uint32_t>& owner, size_t rings, size_t run_length, Merge&& merge) {
+    const auto filled = fill(owner, rings);
+    uint64_t expected = 0;
+    bool ordered = true;
+    const bench::Stopwatch watch;
+    merge(pointers(filled), [&](const Tick& tick) {
+        ordered &= tick.ns == expected;
+        ++expected;
+    });
+    const double ns = watch.ns();
+    const bool ok = ordered && expected == owner.size();
+    std::printf("rings=%zu run=%zu method=%s ns_per_element=%.1f %s\n", rings, run_length, method,
+                ns / static_cast<double>(owner.size()), ok ? "ok" : "MISORDERED");
+    return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const size_t ticks = bench::flag_size(argc, argv, "ticks", 1000000);
+        const std::vector<size_t> ring_counts = parse_list(bench::flag(argc, argv, "rings", "16,64"));
+        const std::vector<size_t> runs = parse_list(bench::flag(argc, argv, "runs", "1,32"));
+        if (ticks == 0) {
+            std::fprintf(stderr, "bench_merge_rings: need --ticks > 0\n");
+            return 1;
+        }
+
+        bool ok = true;
+        for (const size_t rings : ring_counts) {
+            for (const size_t run_length : runs) {
+                const std::vector<uint32_t> owner = deal(ticks, rings, run_length);
+                ok &= run("pop", owner, rings, run_length, [](std::vector<RingBuffer<Tick>*> list, auto&& sink) {
+                    MergedRingReader<Tick, NsOf> merged(std::move(list));
+                    Tick tick{};
+                    while (merged.try_pop(tick)) {
+                        sink(tick);
+                    }
+                });
+                ok &= run("consume", owner, rings, run_length, [](std::vector<RingBuffer<Tick>*> list, auto&& sink) {
+                    MergedRingReader<Tick, NsOf> merged(std::move(list));
+                    merged.consume([&](Tick&& tick) { sink(tick); });
+                });
+                ok &= run("scan", owner, rings, run_length, [](std::vector<RingBuffer<Tick>*> list, auto&& sink) {
+                    for (;;) {
+                        RingBuffer<Tick>* earliest = nullptr;
+                        for (RingBuffer<Tick>* ring : list) {
+                            if (!ring->empty() && (earliest == nullptr || ring->front().ns < earliest->front().ns)) {
+                                earliest = ring;
+                            }
+                        }
+                        if (earliest == nullptr) {
+                            break;
+                        }
+                        sink(earliest->front());
+                        earliest->discard(1);
+                    }
+                });
+            }
+        }
+        return ok ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_merge_rings: %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,192 @@
+// Compares the sequence-numbered MpmcRingBuffer with the tagged-slot
+// TaggedRingBuffer under the same producer/consumer load, for an 8-byte
+// payload and a 16-byte (pointer, tag) payload. Every element is checked on
+// the way out, so a lost or duplicated element fails the run. MpmcRingBuffer
+// then moves the 8-byte payload in batches of 1, 8 and 32 with try_push_bulk
+// and try_pop_bulk.
+//
+//   bench_mpmc_rings [--producers 2] [--consumers 2] [--ops 2000000] [--capacity 1024]
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "ringbuff_mpmc.hpp"
+#include "ringbuff_tagged.hpp"
+
+namespace {
+
+struct TaggedPointer {
+    void* pointer;
+    uint64_t tag;
+};
+
+uint64_t value_of(uint64_t item) {
+    return item;
+}
+
+uint64_t value_of(const TaggedPointer& item) {
+    return item.tag;
+}
+
+template <typename T>
+T make_item(uint64_t value) {
+    if constexpr (sizeof(T) == sizeof(uint64_t)) {
+        return value;
+    } else {
+        return T{nullptr, value};
+    }
+}
+
+struct Config {
+    size_t producers;
+    size_t consumers;
+    size_t ops;
+    size_t capacity;
+};
+
+// Runs one load and prints its line; returns false if the checksum is off.
+template <template <typename> class Ring, typename T>
+bool run(const char* ring_name, const Config& config) {
+    Ring<T> ring(config.capacity);
+    const size_t per_producer = config.ops / config.producers;
+    const size_t total = per_producer * config.producers;
+    std::atomic<size_t> consumed{0};
+    std::atomic<uint64_t> checksum{0};
+
+    const bench::Stopwatch watch;
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < config.producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (size_t i = 0; i < per_producer; ++i) {
+                const T item = make_item<T>(p * per_producer + i + 1);
+                while (!ring.try_push(item)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (size_t c = 0; c < config.consumers; ++c) {
+        threads.emplace_back([&] {
+            uint64_t sum = 0;
+            T item{};
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                if (ring.try_pop(item)) {
+                    sum += value_of(item);
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            checksum.fetch_add(sum, std::memory_order_relaxed);
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    const double ns = watch.ns();
+
+    const uint64_t expected = static_cast<uint64_t>(total) * (total + 1) / 2;
+    const bool ok = checksum.load() == expected;
+    std::printf("ring=%s payload=%zu producers=%zu consumers=%zu ops=%zu ns_per_op=%.1f checksum=%s\n", ring_name,
+                sizeof(T), config.producers, config.consumers, total, ns / static_cast<double>(total),
+                ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+// Runs the 8-byte load through MpmcRingBuffer's bulk calls, `batch` elements
+// per call; returns false if the checksum is off.
+bool run_bulk(size_t batch, const Config& config) {
+    MpmcRingBuffer<uint64_t> ring(config.capacity);
+    const size_t per_producer = config.ops / config.producers;
+    const size_t total = per_producer * config.producers;
+    std::atomic<size_t> consumed{0};
+    std::atomic<uint64_t> checksum{0};
+
+    const bench::Stopwatch watch;
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < config.producers; ++p) {
+        threads.emplace_back([&, p] {
+            std::vector<uint64_t> items(batch);
+            for (size_t i = 0; i < per_producer;) {
+                const size_t count = std::min(batch, per_producer - i);
+                for (size_t j = 0; j < count; ++j) {
+                    items[j] = p * per_producer + i + j + 1;
+                }
+                for (size_t sent = 0; sent < count;) {
+                    const size_t pushed = ring.try_push_bulk(items.data() + sent, count - sent);
+                    if (pushed == 0) {
+                        std::this_thread::yield();
+                    }
+                    sent += pushed;
+                }
+                i += count;
+            }
+        });
+    }
+    for (size_t c = 0; c < config.consumers; ++c) {
+        threads.emplace_back([&] {
+            uint64_t sum = 0;
+            std::vector<uint64_t> items(batch);
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                const size_t popped = ring.try_pop_bulk(std::span<uint64_t>(items));
+                if (popped == 0) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                for (size_t j = 0; j < popped; ++j) {
+                    sum += items[j];
+                }
+                consumed.fetch_add(popped, std::memory_order_relaxed);
+            }
+            checksum.fetch_add(sum, std::memory_order_relaxed);
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    const double ns = watch.ns();
+
+    const uint64_t expected = static_cast<uint64_t>(total) * (total + 1) / 2;
+    const bool ok = checksum.load() == expected;
+    std::printf("ring=sequence_bulk payload=8 batch=%zu producers=%zu consumers=%zu ops=%zu ns_per_op=%.1f "
+                "checksum=%s\n",
+                batch, config.producers, config.consumers, total, ns / static_cast<double>(total),
+                ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Config config{};
+        config.producers = bench::flag_size(argc, argv, "producers", 2);
+        config.consumers = bench::flag_size(argc, argv, "consumers", 2);
+        config.ops = bench::flag_size(argc, argv, "ops", 2000000);
+        config.capacity = bench::flag_size(argc, argv, "capacity", 1024);
+        if (config.producers == 0 || config.consumers == 0 || config.ops < config.producers) {
+            std::fprintf(stderr, "bench_mpmc_rings: need at least one producer, one consumer and one op each\n");
+            return 1;
+        }
+
+        bool ok = true;
+        ok &= run<MpmcRingBuffer, uint64_t>("sequence", config);
+        ok &= run<TaggedRingBuffer, uint64_t>("tagged", config);
+        ok &= run<MpmcRingBuffer, TaggedPointer>("sequence", config);
+        ok &= run<TaggedRingBuffer, TaggedPointer>("tagged", config);
+        for (const size_t batch : {1, 8, 32}) {
+            ok &= run_bulk(batch, config);
+        }
+        return ok ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_mpmc_rings: %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,211 @@
+// Runs PackedRingBuffer<1>, <2> and <4> and RingBuffer<bool> through random
+// pushes, pops, discards and clears next to a std::deque<uint8_t> model, at
+// capacities around the word size so that every run wraps. After each
+// operation the size and every count() are compared with the model, and the
+// contents every 64 operations. It then times push, pop, discard and count()
+// on a full ring, with discard against popping the same number of values.
+//
+//   bench_packed [--ops 200000] [--capacity 1000000]
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "ringbuff.hpp"
+#include "ringbuff_packed.hpp"
+
+namespace {
+
+uint64_t next(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// RingBuffer<bool> behind the PackedRingBuffer<1> interface, so one check
+// covers both.
+class FlagRing {
+public:
+    static constexpr uint8_t max_value = 1;
+
+    explicit FlagRing(size_t capacity) : ring_(capacity) {}
+
+    void push(uint8_t value) { ring_.push(value != 0); }
+    bool try_push(uint8_t value) { return ring_.try_push(value != 0); }
+    uint8_t pop() { return ring_.pop() ? 1 : 0; }
+    uint8_t front() const { return ring_.front() ? 1 : 0; }
+    uint8_t at(size_t index) const { return ring_.at(index) ? 1 : 0; }
+    size_t count(uint8_t value) const { return value == 1 ? ring_.count() : ring_.size() - ring_.count(); }
+    void discard(size_t count) { ring_.discard(count); }
+    void clear() { ring_.clear(); }
+    bool full() const { return ring_.full(); }
+    size_t size() const { return ring_.size(); }
+
+private:
+    RingBuffer<bool> ring_;
+};
+
+// Returns a description of the first difference between ring and model, or "".
+template <typename Ring>
+std::string compare(const Ring& ring, const std::deque<uint8_t>& model, bool contents) {
+    if (ring.size() != model.size()) {
+        return "size " + std::to_string(ring.size()) + " != " + std::to_string(model.size());
+    }
+    std::vector<size_t> counts(Ring::max_value + 1);
+    for (const uint8_t value : model) {
+        ++counts[value];
+    }
+    for (unsigned value = 0; value <= Ring::max_value; ++value) {
+        if (ring.count(static_cast<uint8_t>(value)) != counts[value]) {
+            return "count(" + std::to_string(value) + ") " + std::to_string(ring.count(static_cast<uint8_t>(value))) +
+                   " != " + std::to_string(counts[value]);
+        }
+    }
+    if (!model.empty() && ring.front() != model.front()) {
+        return "front";
+    }
+    for (size_t i = 0; contents && i < model.size(); ++i) {
+        if (ring.at(i) != model[i]) {
+            return "at(" + std::to_string(i) + ")";
+        }
+    }
+    return {};
+}
+
+// Applies `ops` random operations to a ring and the model. Returns false on
+// the first difference.
+template <typename Ring>
+bool check(const char* name, size_t capacity, size_t ops) {
+    Ring ring(capacity);
+    std::deque<uint8_t> model;
+    uint64_t state = 0x9e3779b97f4a7c15ULL ^ capacity;
+    for (size_t op = 0; op < ops; ++op) {
+        const uint64_t roll = next(state);
+        const auto value = static_cast<uint8_t>((roll >> 8) % (Ring::max_value + 1));
+        const unsigned kind = roll % 100;
+        const char* what = "push";
+        if (kind < 50) {
+            ring.push(value);
+            if (model.size() == capacity) {
+                model.pop_front();
+            }
+            model.push_back(value);
+        } else if (kind < 60) {
+            what = "try_push";
+            if (ring.try_push(value) != (model.size() < capacity)) {
+                std::printf("type=%s capacity=%zu op=%zu try_push result MISMATCH\n", name, capacity, op);
+                return false;
+            }
+            if (model.size() < capacity) {
+                model.push_back(value);
+            }
+        } else if (kind < 85) {
+            what = "pop";
+            if (!model.empty()) {
+                if (ring.pop() != model.front()) {
+                    std::printf("type=%s capacity=%zu op=%zu pop value MISMATCH\n", name, capacity, op);
+                    return false;
+                }
+                model.pop_front();
+            }
+        } else if (kind < 99) {
+            what = "discard";
+            const size_t count = model.empty() ? 0 : (roll >> 16) % (model.size() + 1);
+            ring.discard(count);
+            model.erase(model.begin(), model.begin() + static_cast<std::ptrdiff_t>(count));
+        } else {
+            what = "clear";
+            ring.clear();
+            model.clear();
+        }
+        const std::string difference = compare(ring, model, op % 64 == 0);
+        if (!difference.empty()) {
+            std::printf("type=%s capacity=%zu op=%zu after=%s %s MISMATCH\n", name, capacity, op, what,
+                        difference.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Ring>
+bool check_all(const char* name, size_t ops) {
+    bool ok = true;
+    for (const size_t capacity : {1, 3, 63, 64, 65, 1000, 4099}) {
+        ok &= check<Ring>(name, capacity, ops);
+    }
+    std::printf("check type=%s capacities=1,3,63,64,65,1000,4099 ops=%zu %s\n", name, ops, ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+template <typename Ring>
+void fill(Ring& ring, size_t capacity, uint64_t& state) {
+    for (size_t i = 0; i < capacity; ++i) {
+        ring.push(static_cast<uint8_t>(next(state) % (Ring::max_value + 1)));
+    }
+}
+
+// Times each operation on a full ring of `capacity` values that has wrapped.
+template <typename Ring>
+void time_ops(const char* name, size_t capacity) {
+    Ring ring(capacity);
+    uint64_t state = 0x2545f4914f6cdd1dULL;
+    fill(ring, capacity + capacity / 3, state);
+
+    const bench::Stopwatch push_watch;
+    fill(ring, capacity, state);
+    const double push_ns = push_watch.ns() / static_cast<double>(capacity);
+
+    size_t sum = 0;
+    const bench::Stopwatch count_watch;
+    for (size_t i = 0; i < 1000; ++i) {
+        sum += ring.count(static_cast<uint8_t>(i % (Ring::max_value + 1)));
+    }
+    const double count_ns = count_watch.ns() / 1000;
+
+    const bench::Stopwatch pop_watch;
+    for (size_t i = 0; i < capacity; ++i) {
+        sum += ring.pop();
+    }
+    const double pop_ns = pop_watch.ns() / static_cast<double>(capacity);
+
+    fill(ring, capacity, state);
+    const bench::Stopwatch discard_watch;
+    ring.discard(capacity - 7);
+    const double discard_ns = discard_watch.ns() / static_cast<double>(capacity - 7);
+    bench::keep(sum);
+
+    std::printf("type=%s capacity=%zu ns_per_push=%.2f ns_per_pop=%.2f ns_per_discarded=%.3f ns_per_count=%.1f\n",
+                name, capacity, push_ns, pop_ns, discard_ns, count_ns);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const size_t ops = bench::flag_size(argc, argv, "ops", 200000);
+        const size_t capacity = bench::flag_size(argc, argv, "capacity", 1000000);
+        if (capacity < 8) {
+            std::fprintf(stderr, "bench_packed: need --capacity >= 8\n");
+            return 1;
+        }
+        bool ok = check_all<PackedRingBuffer<1>>("packed1", ops);
+        ok &= check_all<PackedRingBuffer<2>>("packed2", ops);
+        ok &= check_all<PackedRingBuffer<4>>("packed4", ops);
+        ok &= check_all<FlagRing>("bool", ops);
+
+        time_ops<PackedRingBuffer<1>>("packed1", capacity);
+        time_ops<PackedRingBuffer<2>>("packed2", capacity);
+        time_ops<PackedRingBuffer<4>>("packed4", capacity);
+        time_ops<FlagRing>("bool", capacity);
+        return ok ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_packed: %s\n", e.what());
+        return 1;
+    }
+}
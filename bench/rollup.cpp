@@ -0,0 +1,79 @@
+// Builds the README's MultiResolutionRing (an hour of seconds, a day of
+// minutes, a year of hours), feeds it one sample per second and times push().
+// The newest span of each level, and the automatic query(from, to) over a
+// week, are then checked against aggregates recomputed from the samples.
+//
+//   bench_rollup [--days 365]
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+
+#include "bench_common.hpp"
+#include "ringbuff_rollup.hpp"
+
+namespace {
+
+// The sample taken at second t: deterministic, so any range can be recomputed.
+double sample(uint64_t t) {
+    uint64_t x = t * 0x9E3779B97F4A7C15ull;
+    x ^= x >> 29;
+    return static_cast<double>(x % 100000) / 100.0;
+}
+
+RollupBucket exact(uint64_t from, uint64_t to) {
+    RollupBucket bucket;
+    for (uint64_t t = from; t < to; ++t) {
+        bucket.add(sample(t));
+    }
+    return bucket;
+}
+
+// Returns false if the query and the recomputed aggregate disagree.
+bool check(const char* name, size_t level, const RollupBucket& got, const RollupBucket& want) {
+    const bool ok = got.count == want.count && got.min == want.min && got.max == want.max &&
+                    std::fabs(got.sum - want.sum) <= 1e-9 * std::fabs(want.sum);
+    std::printf("query=%s level=%zu samples=%llu mean=%.3f min=%.2f max=%.2f %s\n", name, level,
+                static_cast<unsigned long long>(got.count), got.mean(), got.min, got.max, ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const uint64_t seconds = bench::flag_size(argc, argv, "days", 365) * 86400;
+        if (seconds < 31 * 86400) {
+            std::fprintf(stderr, "bench_rollup: need --days of at least 31\n");
+            return 1;
+        }
+        MultiResolutionRing ring({{1, 3600}, {60, 1440}, {3600, 24 * 365}});
+        std::printf("levels=%zu memory_kb=%.1f\n", ring.levels(), static_cast<double>(ring.memory_bytes()) / 1024);
+
+        const bench::Stopwatch push_watch;
+        for (uint64_t t = 0; t < seconds; ++t) {
+            ring.push(t, sample(t));
+        }
+        std::printf("samples=%llu ns_per_push=%.2f\n", static_cast<unsigned long long>(seconds),
+                    push_watch.ns() / static_cast<double>(seconds));
+
+        // The newest span of each level, starting at a period boundary that
+        // the level still holds.
+        bool ok = true;
+        const char* names[] = {"last_hour", "last_day", "last_30_days"};
+        const uint64_t spans[] = {3599, 1439 * 60, 30 * 86400};
+        const uint64_t last = seconds - 1;
+        for (size_t level = 0; level < ring.levels(); ++level) {
+            const uint64_t period = ring.resolution(level).period;
+            const uint64_t from = (last - spans[level]) / period * period;
+            ok &= check(names[level], level, ring.query(level, from, seconds), exact(from, seconds));
+        }
+        const uint64_t week = seconds - 7 * 86400;
+        ok &= check("last_week", ring.level_for(week), ring.query(week, seconds), exact(week, seconds));
+        return ok ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_rollup: %s\n", e.what());
+        return 1;
+    }
+}
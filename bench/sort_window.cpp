@@ -0,0 +1,156 @@
+// Times RingBuffer::sorted_copy(), sort() and nth_element_copy() on a wrapped
+// window of random doubles and of random uint32_t values, against copying the
+// two segments out and running std::sort or std::nth_element on the copy.
+// Every result is checked against the std::sort one.
+//
+//   bench_sort_window [--n 1000000] [--reps 5]
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "ringbuff.hpp"
+
+namespace {
+
+uint64_t next(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+std::vector<double> random_doubles(size_t count) {
+    std::vector<double> values(count);
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    for (double& value : values) {
+        value = (static_cast<double>(next(state) >> 11) / 9007199254740992.0 - 0.5) * 2e6;
+    }
+    return values;
+}
+
+std::vector<uint32_t> random_uint32(size_t count) {
+    std::vector<uint32_t> values(count);
+    uint64_t state = 0x2545f4914f6cdd1dULL;
+    for (uint32_t& value : values) {
+        value = static_cast<uint32_t>(next(state) >> 32);
+    }
+    return values;
+}
+
+// Fills a ring with `values` so that its contents wrap around the storage end.
+template <typename T>
+void fill(RingBuffer<T>& ring, const std::vector<T>& values) {
+    ring.clear();
+    for (size_t i = 0; i < ring.capacity() / 3; ++i) {
+        ring.push(T{});
+    }
+    ring.discard(ring.size());
+    for (const T value : values) {
+        ring.push(value);
+    }
+}
+
+template <typename T>
+std::vector<T> copy_out(const RingBuffer<T>& ring) {
+    const auto [first, second] = ring.segments();
+    std::vector<T> out(first.begin(), first.end());
+    out.insert(out.end(), second.begin(), second.end());
+    return out;
+}
+
+template <typename T>
+bool ring_equals(const RingBuffer<T>& ring, const std::vector<T>& expected) {
+    return copy_out(ring) == expected;
+}
+
+void report(const char* type, const char* method, size_t n, double ns, size_t reps, bool ok) {
+    std::printf("type=%s n=%zu method=%s ms=%.2f %s\n", type, n, method, ns / 1e6 / static_cast<double>(reps),
+                ok ? "ok" : "MISMATCH");
+}
+
+// Returns false if any method disagrees with std::sort.
+template <typename T>
+bool run(const char* type, const std::vector<T>& values, size_t reps) {
+    const size_t n = values.size();
+    RingBuffer<T> ring(n);
+    fill(ring, values);
+
+    std::vector<T> expected;
+    double ns = 0;
+    for (size_t rep = 0; rep < reps; ++rep) {
+        const bench::Stopwatch watch;
+        expected = copy_out(ring);
+        std::sort(expected.begin(), expected.end());
+        ns += watch.ns();
+    }
+    report(type, "copy_std_sort", n, ns, reps, true);
+
+    bool ok = true;
+    bool all_ok = true;
+    ns = 0;
+    for (size_t rep = 0; rep < reps; ++rep) {
+        const bench::Stopwatch watch;
+        const std::vector<T> sorted = ring.sorted_copy();
+        ns += watch.ns();
+        ok &= sorted == expected;
+    }
+    report(type, "sorted_copy", n, ns, reps, ok);
+    all_ok &= ok;
+
+    ok = true;
+    ns = 0;
+    for (size_t rep = 0; rep < reps; ++rep) {
+        fill(ring, values);
+        const bench::Stopwatch watch;
+        ring.sort();
+        ns += watch.ns();
+        ok &= ring_equals(ring, expected);
+    }
+    report(type, "sort_in_place", n, ns, reps, ok);
+    all_ok &= ok;
+
+    fill(ring, values);
+    ns = 0;
+    for (size_t rep = 0; rep < reps; ++rep) {
+        const bench::Stopwatch watch;
+        std::vector<T> copy = copy_out(ring);
+        std::nth_element(copy.begin(), copy.begin() + static_cast<std::ptrdiff_t>(n / 2), copy.end());
+        bench::keep(copy[n / 2]);
+        ns += watch.ns();
+    }
+    report(type, "copy_std_nth_element", n, ns, reps, true);
+
+    ok = true;
+    ns = 0;
+    for (size_t rep = 0; rep < reps; ++rep) {
+        const bench::Stopwatch watch;
+        const T median = ring.nth_element_copy(n / 2);
+        ns += watch.ns();
+        ok &= median == expected[n / 2];
+    }
+    report(type, "nth_element_copy", n, ns, reps, ok);
+    return all_ok && ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const size_t n = bench::flag_size(argc, argv, "n", 1000000);
+        const size_t reps = bench::flag_size(argc, argv, "reps", 5);
+        if (n == 0 || reps == 0) {
+            std::fprintf(stderr, "bench_sort_window: need --n and --reps > 0\n");
+            return 1;
+        }
+        bool ok = run("double", random_doubles(n), reps);
+        ok &= run("uint32", random_uint32(n), reps);
+        return ok ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_sort_window: %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,153 @@
+// Checks RingFft and SlidingDft against a direct O(N^2) DFT in double
+// precision, then times them. RingFft is checked for every power-of-two size
+// from 2 to 1024, with rectangular and Hann windows, on rings that have
+// wrapped; SlidingDft is checked along 100k pushes. Errors are relative to
+// the sum of the weighted sample magnitudes, which bounds every bin.
+//
+//   bench_spectrum [--size 4096] [--calls 2000] [--pushes 100000] [--tolerance 1e-5]
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <numbers>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "ringbuff_spectrum.hpp"
+
+namespace {
+
+float next_sample(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return static_cast<float>(static_cast<double>(state % 20001) / 10000.0 - 1.0);
+}
+
+// The newest `size` samples of a ring, oldest first.
+std::vector<double> newest(const RingBuffer<float>& ring, size_t size) {
+    std::vector<double> samples;
+    for (size_t i = ring.size() - size; i < ring.size(); ++i) {
+        samples.push_back(ring.at(i));
+    }
+    return samples;
+}
+
+// Bin k of the direct DFT of samples, optionally Hann-weighted as RingFft does.
+std::complex<double> direct_bin(const std::vector<double>& samples, size_t k, bool hann) {
+    const size_t n = samples.size();
+    std::complex<double> sum = 0.0;
+    for (size_t m = 0; m < n; ++m) {
+        const double weight =
+            hann ? 0.5 - 0.5 * std::cos(2.0 * std::numbers::pi * static_cast<double>(m) / static_cast<double>(n)) : 1.0;
+        sum += samples[m] * weight *
+               std::polar(1.0, -2.0 * std::numbers::pi * static_cast<double>((k * m) % n) / static_cast<double>(n));
+    }
+    return sum;
+}
+
+double l1(const std::vector<double>& samples) {
+    double sum = 0;
+    for (const double sample : samples) {
+        sum += std::fabs(sample);
+    }
+    return sum;
+}
+
+// Returns the largest relative error of RingFft over all sizes and windows.
+double check_fft(uint64_t& state) {
+    double worst = 0;
+    for (size_t size = 2; size <= 1024; size *= 2) {
+        for (const bool hann : {false, true}) {
+            RingBuffer<float> ring(size + 37);
+            for (size_t i = 0; i < 2 * size + 50; ++i) {
+                ring.push(next_sample(state));
+            }
+            RingFft fft(size, hann ? SpectrumWindow::Hann : SpectrumWindow::Rectangular);
+            const auto bins = fft.transform(ring);
+            const std::vector<double> samples = newest(ring, size);
+            const double scale = l1(samples);
+            for (size_t k = 0; k < size; ++k) {
+                const std::complex<double> got(bins[k].real(), bins[k].imag());
+                worst = std::max(worst, std::abs(got - direct_bin(samples, k, hann)) / scale);
+            }
+        }
+    }
+    return worst;
+}
+
+// Returns the largest relative error of SlidingDft along `pushes` pushes,
+// checked every 97 pushes and after the last one.
+double check_sliding(uint64_t& state, size_t pushes) {
+    const size_t size = 1000;
+    const std::vector<size_t> bins{0, 1, 50, 60, 499};
+    SlidingDft sliding(size, bins);
+    RingBuffer<float> ring(size);
+    for (size_t i = 0; i < size; ++i) {
+        ring.push(0.0f);
+    }
+    double worst = 0;
+    for (size_t i = 1; i <= pushes; ++i) {
+        const float sample = next_sample(state);
+        sliding.push(sample);
+        ring.push(sample);
+        if (i % 97 == 0 || i == pushes) {
+            const std::vector<double> samples = newest(ring, size);
+            const double scale = std::max(l1(samples), 1.0);
+            for (size_t b = 0; b < bins.size(); ++b) {
+                worst = std::max(worst, std::abs(sliding.value(b) - direct_bin(samples, bins[b], false)) / scale);
+            }
+        }
+    }
+    return worst;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const size_t size = bench::flag_size(argc, argv, "size", 4096);
+        const size_t calls = bench::flag_size(argc, argv, "calls", 2000);
+        const size_t pushes = bench::flag_size(argc, argv, "pushes", 100000);
+        const double tolerance = bench::flag_double(argc, argv, "tolerance", 1e-5);
+        if (calls == 0 || pushes == 0) {
+            std::fprintf(stderr, "bench_spectrum: need --calls and --pushes > 0\n");
+            return 1;
+        }
+        uint64_t state = 0x9e3779b97f4a7c15ULL;
+
+        const double fft_error = check_fft(state);
+        const double sliding_error = check_sliding(state, pushes);
+        const bool ok = fft_error <= tolerance && sliding_error <= tolerance;
+        std::printf("check ring_fft_sizes=2..1024 max_rel_error=%.2e sliding_dft_pushes=%zu max_rel_error=%.2e %s\n",
+                    fft_error, pushes, sliding_error, ok ? "ok" : "FAILED");
+
+        RingBuffer<float> ring(size + size / 2);
+        for (size_t i = 0; i < ring.capacity() + size / 3; ++i) {
+            ring.push(next_sample(state));
+        }
+        RingFft fft(size);
+        const bench::Stopwatch fft_watch;
+        for (size_t i = 0; i < calls; ++i) {
+            bench::keep(fft.power_spectrum(ring)[1]);
+        }
+        std::printf("ring_fft size=%zu window=hann us_per_power_spectrum=%.1f\n", size,
+                    fft_watch.ns() / 1e3 / static_cast<double>(calls));
+
+        SlidingDft hum(1000, {50, 60});
+        const bench::Stopwatch sliding_watch;
+        for (size_t i = 0; i < pushes; ++i) {
+            hum.push(next_sample(state));
+        }
+        const double sliding_ns = sliding_watch.ns();
+        bench::keep(hum.value(0));
+        std::printf("sliding_dft size=1000 bins=2 ns_per_push=%.1f\n", sliding_ns / static_cast<double>(pushes));
+        return ok ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_spectrum: %s\n", e.what());
+        return 1;
+    }
+}
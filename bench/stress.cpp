@@ -0,0 +1,91 @@
+// Runs run_stress() against the concurrent queues and exits non-zero on the
+// first anomaly. The build also produces bench_stress_tsan and
+// bench_stress_tsan_seqcst, the same driver under ThreadSanitizer with the
+// minimal memory orders and with RING_STRICT_SEQCST; ctest runs all three.
+// --soak keeps repeating rounds for the given number of seconds. --bulk moves
+// random batches of 8..64 values through MpmcRingBuffer's try_push_bulk and
+// try_pop_bulk instead; the other queues have no bulk operations.
+//
+//   bench_stress [--queue all|mpmc|tagged|unbounded] [--producers 4] [--consumers 4]
+//                [--items 100000] [--capacity 1024] [--soak 0] [--seed 1] [--history] [--bulk]
+
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <string>
+
+#include "bench_common.hpp"
+#include "ringbuff_memory_order.hpp"
+#include "ringbuff_mpmc.hpp"
+#include "ringbuff_stress.hpp"
+#include "ringbuff_tagged.hpp"
+#include "ringbuff_unbounded.hpp"
+
+namespace {
+
+bool report(const char* name, const StressReport& result) {
+    std::printf("queue=%s strict_seqcst=%d rounds=%llu pushed=%llu popped=%llu lost=%llu duplicated=%llu "
+                "reordered=%llu corrupt=%llu history_ops=%llu seconds=%.2f ops_per_s=%.0f %s\n",
+                name, ring_order::strict ? 1 : 0, static_cast<unsigned long long>(result.rounds),
+                static_cast<unsigned long long>(result.pushed), static_cast<unsigned long long>(result.popped),
+                static_cast<unsigned long long>(result.lost), static_cast<unsigned long long>(result.duplicated),
+                static_cast<unsigned long long>(result.reordered), static_cast<unsigned long long>(result.corrupt),
+                static_cast<unsigned long long>(result.history_ops), result.seconds, result.ops_per_second,
+                result.ok() ? "ok" : "FAILED");
+    if (!result.violation.empty()) {
+        std::printf("queue=%s violation: %s\n", name, result.violation.c_str());
+    }
+    return result.ok();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const std::string queue = bench::flag(argc, argv, "queue", "all");
+        const size_t capacity = bench::flag_size(argc, argv, "capacity", 1024);
+        StressOptions options;
+        options.producers = bench::flag_size(argc, argv, "producers", 4);
+        options.consumers = bench::flag_size(argc, argv, "consumers", 4);
+        options.items_per_producer = bench::flag_size(argc, argv, "items", 100000);
+        options.soak = std::chrono::milliseconds(
+            static_cast<long long>(bench::flag_double(argc, argv, "soak", 0) * 1000));
+        options.seed = bench::flag_size(argc, argv, "seed", 1);
+        options.record_history = bench::has_flag(argc, argv, "history");
+        const bool bulk = bench::has_flag(argc, argv, "bulk");
+        if (bulk) {
+            options.bulk_min = 8;
+            options.bulk_max = 64;
+        }
+        if (queue != "all" && queue != "mpmc" && queue != "tagged" && queue != "unbounded") {
+            std::fprintf(stderr, "bench_stress: unknown --queue %s\n", queue.c_str());
+            return 1;
+        }
+        if (bulk && queue != "all" && queue != "mpmc") {
+            std::fprintf(stderr, "bench_stress: --bulk needs --queue mpmc\n");
+            return 1;
+        }
+
+        bool ok = true;
+        if (queue == "all" || queue == "mpmc") {
+            // Empty pops on MpmcRingBuffer are not linearizable by design, so
+            // its history is not checked.
+            StressOptions mpmc_options = options;
+            mpmc_options.record_history = false;
+            MpmcRingBuffer<uint64_t> ring(capacity);
+            ok &= report(bulk ? "mpmc_bulk" : "mpmc", run_stress(ring, mpmc_options));
+        }
+        if (!bulk && (queue == "all" || queue == "tagged")) {
+            TaggedRingBuffer<uint64_t> ring(capacity);
+            ok &= report("tagged", run_stress(ring, options));
+        }
+        if (!bulk && (queue == "all" || queue == "unbounded")) {
+            UnboundedRing<uint64_t> ring(capacity);
+            ok &= report("unbounded", run_stress(ring, options));
+        }
+        return ok ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_stress: %s\n", e.what());
+        return 1;
+    }
+}
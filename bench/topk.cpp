@@ -0,0 +1,84 @@
+// Measures WindowedTopK::push() with random keys once the window is full, so
+// every push also evicts, then top(k). The window's counts and top(k) are
+// checked against counts recomputed from the last `window` keys.
+//
+//   bench_topk [--keys 100000] [--window 1048576] [--pushes 4000000] [--k 20]
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <utility>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "ringbuff_topk.hpp"
+
+namespace {
+
+// Random keys below `keys`, skewed so that a few keys are hot: half the draws
+// come from the first 1% of the key space.
+std::vector<uint64_t> draw_keys(size_t pushes, size_t keys) {
+    std::vector<uint64_t> drawn(pushes);
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    const size_t hot = std::max<size_t>(keys / 100, 1);
+    for (uint64_t& key : drawn) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        key = (state & 1) ? (state >> 1) % hot : (state >> 1) % keys;
+    }
+    return drawn;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const size_t keys = bench::flag_size(argc, argv, "keys", 100000);
+        const size_t window = bench::flag_size(argc, argv, "window", 1 << 20);
+        const size_t pushes = bench::flag_size(argc, argv, "pushes", 4000000);
+        const size_t k = bench::flag_size(argc, argv, "k", 20);
+        if (keys == 0 || window == 0 || pushes <= window) {
+            std::fprintf(stderr, "bench_topk: need --keys, --window > 0 and more --pushes than --window\n");
+            return 1;
+        }
+        const std::vector<uint64_t> drawn = draw_keys(pushes, keys);
+
+        WindowedTopK<uint64_t> top_keys(window);
+        for (size_t i = 0; i < window; ++i) {
+            top_keys.push(drawn[i], i);
+        }
+        const bench::Stopwatch push_watch;
+        for (size_t i = window; i < pushes; ++i) {
+            top_keys.push(drawn[i], i);
+        }
+        const double push_ns = push_watch.ns();
+
+        const bench::Stopwatch top_watch;
+        const std::vector<std::pair<uint64_t, uint64_t>> top = top_keys.top(k);
+        const double top_ns = top_watch.ns();
+
+        std::vector<uint64_t> exact(keys);
+        for (size_t i = pushes - window; i < pushes; ++i) {
+            ++exact[drawn[i]];
+        }
+        size_t wrong = 0;
+        for (size_t key = 0; key < keys; ++key) {
+            wrong += top_keys.count(key) != exact[key];
+        }
+        std::vector<uint64_t> expected = exact;
+        std::sort(expected.begin(), expected.end(), std::greater<>());
+        for (size_t i = 0; i < top.size(); ++i) {
+            wrong += top[i].second != expected[i] || exact[top[i].first] != top[i].second;
+        }
+
+        std::printf("keys=%zu window=%zu ns_per_push=%.1f top%zu_us=%.2f wrong_counts=%zu %s\n", keys, window,
+                    push_ns / static_cast<double>(pushes - window), k, top_ns / 1e3, wrong,
+                    wrong == 0 ? "ok" : "FAILED");
+        return wrong == 0 ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_topk: %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,213 @@
+// Round-trips data through the io_uring adapters and checks every byte. A
+// RingWriter drains a ring of sequence numbers to a file, once with
+// IORING_OP_WRITEV and once with IORING_OP_WRITE_FIXED on the registered
+// ring storage, and the file is read back. A RingReader then receives the
+// same sequence from a TCP connection over loopback, which a second thread
+// feeds in chunks that split elements. The ring is smaller than the data, so
+// every run wraps many times.
+//
+//   bench_uring [--dir /tmp] [--items 1000000] [--capacity 1000] [--chunk 4093]
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "ringbuff_uring.hpp"
+
+namespace {
+
+// Closes a file descriptor on destruction.
+class Fd {
+public:
+    explicit Fd(int fd) : fd_(fd) {
+        if (fd_ < 0) {
+            throw std::system_error(errno, std::generic_category(), "bench_uring");
+        }
+    }
+
+    ~Fd() { reset(); }
+
+    Fd(const Fd&) = delete;
+    Fd& operator=(const Fd&) = delete;
+
+    int get() const { return fd_; }
+
+    void reset() {
+        if (fd_ >= 0) {
+            close(fd_);
+            fd_ = -1;
+        }
+    }
+
+private:
+    int fd_;
+};
+
+void report(const char* op, size_t items, double ns, bool ok) {
+    const size_t bytes = items * sizeof(uint32_t);
+    std::printf("op=%s items=%zu bytes=%zu mb_per_s=%.0f %s\n", op, items, bytes,
+                static_cast<double>(bytes) * 1e3 / ns, ok ? "ok" : "MISMATCH");
+}
+
+// Checks that `fd` holds the sequence 0, 1, ..., items - 1.
+bool file_holds_sequence(int fd, size_t items) {
+    std::vector<uint32_t> data(items + 1);
+    const size_t bytes = items * sizeof(uint32_t);
+    size_t done = 0;
+    while (done < bytes + 1) {
+        const ssize_t got = pread(fd, reinterpret_cast<char*>(data.data()) + done, bytes + 1 - done,
+                                  static_cast<off_t>(done));
+        if (got <= 0) {
+            break;
+        }
+        done += static_cast<size_t>(got);
+    }
+    if (done != bytes) {
+        return false;
+    }
+    for (size_t i = 0; i < items; ++i) {
+        if (data[i] != i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Writes the sequence to a fresh file under `dir` through a RingWriter, then
+// reads the file back. Returns false if the contents differ.
+bool write_file(IoUring& uring, const std::string& dir, size_t items, size_t capacity, bool fixed) {
+    std::string path = dir + "/bench_uring_XXXXXX";
+    const Fd fd(mkstemp(path.data()));
+    unlink(path.c_str());
+
+    RingBuffer<uint32_t> ring(capacity);
+    RingWriter<uint32_t> writer(uring, ring, fd.get(), 0);
+    if (fixed) {
+        uring.register_buffers({storage_iovec(ring)});
+        writer.use_registered_buffer(0);
+    }
+
+    const uint64_t bytes = items * sizeof(uint32_t);
+    uint32_t next = 0;
+    const bench::Stopwatch watch;
+    while (writer.bytes_written() < bytes) {
+        while (next < items && ring.try_push(next)) {
+            ++next;
+        }
+        writer.prepare();
+        uring.submit(1);
+        uring.reap();
+    }
+    const double ns = watch.ns();
+    if (fixed) {
+        uring.unregister_buffers();
+    }
+
+    const bool ok = file_holds_sequence(fd.get(), items);
+    report(fixed ? "write_fixed" : "writev", items, ns, ok);
+    return ok;
+}
+
+// Receives the sequence from a loopback TCP connection through a RingReader,
+// popping and checking each element as it arrives.
+bool recv_socket(IoUring& uring, size_t items, size_t capacity, size_t chunk) {
+    const Fd listener(socket(AF_INET, SOCK_STREAM, 0));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    if (bind(listener.get(), reinterpret_cast<sockaddr*>(&address), length) != 0 ||
+        listen(listener.get(), 1) != 0 ||
+        getsockname(listener.get(), reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        throw std::system_error(errno, std::generic_category(), "bench_uring: loopback listener");
+    }
+    Fd sender(socket(AF_INET, SOCK_STREAM, 0));
+    if (connect(sender.get(), reinterpret_cast<sockaddr*>(&address), length) != 0) {
+        throw std::system_error(errno, std::generic_category(), "bench_uring: connect");
+    }
+    const Fd receiver(accept(listener.get(), nullptr, nullptr));
+
+    std::vector<uint32_t> data(items);
+    for (size_t i = 0; i < items; ++i) {
+        data[i] = static_cast<uint32_t>(i);
+    }
+    // Sends in chunks of `chunk` bytes, then closes so the reader sees EOF.
+    std::thread feed([&] {
+        const char* bytes = reinterpret_cast<const char*>(data.data());
+        const size_t total = items * sizeof(uint32_t);
+        for (size_t sent = 0; sent < total;) {
+            const ssize_t n = send(sender.get(), bytes + sent, std::min(chunk, total - sent), MSG_NOSIGNAL);
+            if (n < 0 && errno != EINTR) {
+                break;
+            }
+            sent += n > 0 ? static_cast<size_t>(n) : 0;
+        }
+        sender.reset();
+    });
+
+    RingBuffer<uint32_t> ring(capacity);
+    RingReader<uint32_t> reader(uring, ring, receiver.get());
+    size_t expected = 0;
+    bool ordered = true;
+    const bench::Stopwatch watch;
+    try {
+        while (!reader.eof()) {
+            reader.prepare();
+            if (!reader.idle()) {
+                uring.submit(1);
+                uring.reap();
+            }
+            uint32_t value = 0;
+            while (ring.try_pop(value)) {
+                ordered &= value == expected;
+                ++expected;
+            }
+        }
+    } catch (...) {
+        feed.join();
+        throw;
+    }
+    const double ns = watch.ns();
+    feed.join();
+
+    const bool ok = ordered && expected == items && reader.bytes_read() == items * sizeof(uint32_t);
+    report("recv", items, ns, ok);
+    return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const std::string dir = bench::flag(argc, argv, "dir", "/tmp");
+        const size_t items = bench::flag_size(argc, argv, "items", 1000000);
+        const size_t capacity = bench::flag_size(argc, argv, "capacity", 1000);
+        const size_t chunk = bench::flag_size(argc, argv, "chunk", 4093);
+        if (items == 0 || capacity == 0 || chunk == 0) {
+            std::fprintf(stderr, "bench_uring: need --items, --capacity and --chunk > 0\n");
+            return 1;
+        }
+
+        IoUring uring;
+        bool ok = write_file(uring, dir, items, capacity, false);
+        ok &= write_file(uring, dir, items, capacity, true);
+        ok &= recv_socket(uring, items, capacity, chunk);
+        return ok ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_uring: %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,136 @@
+// Measures WindowJoin on a random two-sided event stream against a join that
+// scans every item of the other side inside the window. Both must report the
+// same number of matches. On a prefix of --check events, the exact (left,
+// right) pairs are compared with a nested-loop join over all earlier events.
+//
+//   bench_window_join [--events 1000000] [--keys 1000] [--window 500] [--capacity 65536] [--check 20000]
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "ringbuff_join.hpp"
+
+namespace {
+
+struct Event {
+    bool left;
+    uint64_t key;
+    uint64_t timestamp;
+    uint32_t id;
+};
+
+// Events with random sides and keys and timestamps advancing by 0-9.
+std::vector<Event> make_events(size_t count, size_t keys) {
+    std::vector<Event> events(count);
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    uint64_t timestamp = 0;
+    for (size_t i = 0; i < count; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        timestamp += state % 10;
+        events[i] = Event{((state >> 8) & 1) != 0, (state >> 16) % keys, timestamp, static_cast<uint32_t>(i)};
+    }
+    return events;
+}
+
+using Pairs = std::vector<std::pair<uint32_t, uint32_t>>;
+
+// Joins events[0, count) with WindowJoin, appending (left id, right id) pairs
+// if `pairs` is given. Throws if a side overflows, which would lose matches.
+uint64_t ring_join(const std::vector<Event>& events, size_t count, uint64_t window, size_t capacity, Pairs* pairs) {
+    WindowJoin<uint32_t, uint32_t, uint64_t> join(window, capacity);
+    uint64_t matches = 0;
+    auto on_match = [&](uint32_t left, uint32_t right) {
+        if (pairs != nullptr) {
+            pairs->emplace_back(left, right);
+        }
+    };
+    for (size_t i = 0; i < count; ++i) {
+        const Event& event = events[i];
+        matches += event.left ? join.push_left(event.key, event.timestamp, event.id, on_match)
+                              : join.push_right(event.key, event.timestamp, event.id, on_match);
+    }
+    if (join.overflowed() != 0) {
+        throw std::runtime_error("--capacity is too small for the window");
+    }
+    return matches;
+}
+
+// Joins events[0, count) by scanning the other side's items newest first
+// until one falls outside the window.
+uint64_t scan_join(const std::vector<Event>& events, size_t count, uint64_t window) {
+    std::vector<const Event*> sides[2];
+    uint64_t matches = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const Event& event = events[i];
+        const std::vector<const Event*>& other = sides[event.left ? 1 : 0];
+        for (size_t j = other.size(); j-- > 0 && other[j]->timestamp + window >= event.timestamp;) {
+            matches += other[j]->key == event.key;
+        }
+        sides[event.left ? 0 : 1].push_back(&event);
+    }
+    return matches;
+}
+
+// The reference join: every earlier event of the other side, no early exit.
+Pairs nested_loop_join(const std::vector<Event>& events, size_t count, uint64_t window) {
+    Pairs pairs;
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t j = 0; j < i; ++j) {
+            const Event& a = events[i];
+            const Event& b = events[j];
+            if (a.left != b.left && a.key == b.key && a.timestamp - b.timestamp <= window) {
+                pairs.emplace_back(a.left ? a.id : b.id, a.left ? b.id : a.id);
+            }
+        }
+    }
+    return pairs;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const size_t count = bench::flag_size(argc, argv, "events", 1000000);
+        const size_t keys = bench::flag_size(argc, argv, "keys", 1000);
+        const uint64_t window = bench::flag_size(argc, argv, "window", 500);
+        const size_t capacity = bench::flag_size(argc, argv, "capacity", 65536);
+        const size_t check = std::min(bench::flag_size(argc, argv, "check", 20000), count);
+        if (count == 0 || keys == 0 || capacity == 0) {
+            std::fprintf(stderr, "bench_window_join: need --events, --keys and --capacity > 0\n");
+            return 1;
+        }
+        const std::vector<Event> events = make_events(count, keys);
+
+        const bench::Stopwatch ring_watch;
+        const uint64_t ring_matches = ring_join(events, count, window, capacity, nullptr);
+        const double ring_ns = ring_watch.ns();
+        const bench::Stopwatch scan_watch;
+        const uint64_t scan_matches = scan_join(events, count, window);
+        const double scan_ns = scan_watch.ns();
+        std::printf("join=window_join events=%zu matches=%llu ns_per_push=%.1f\n", count,
+                    static_cast<unsigned long long>(ring_matches), ring_ns / static_cast<double>(count));
+        std::printf("join=window_scan events=%zu matches=%llu ns_per_push=%.1f\n", count,
+                    static_cast<unsigned long long>(scan_matches), scan_ns / static_cast<double>(count));
+
+        Pairs got;
+        ring_join(events, check, window, capacity, &got);
+        Pairs want = nested_loop_join(events, check, window);
+        std::sort(got.begin(), got.end());
+        std::sort(want.begin(), want.end());
+        const bool ok = ring_matches == scan_matches && got == want;
+        std::printf("check events=%zu pairs=%zu nested_loop_pairs=%zu %s\n", check, got.size(), want.size(),
+                    ok ? "ok" : "MISMATCH");
+        return ok ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_window_join: %s\n", e.what());
+        return 1;
+    }
+}
@@ -1,9 +1,19 @@
 #ifndef RING_BUFFER_HPP
 #define RING_BUFFER_HPP
 
-#include <vector>     // For std::vector
-#include <stdexcept>  // For std::invalid_argument, std::out_of_range
-#include <utility>    // For std::forward, std::move
+#include <vector>       // For std::vector
+#include <stdexcept>    // For std::invalid_argument, std::out_of_range
+#include <utility>      // For std::forward, std::move, std::pair
+#include <atomic>       // For std::atomic_ref, std::atomic_thread_fence
+#include <cstdint>      // For uint64_t
+#include <span>         // For std::span
+#include <limits>       // For std::numeric_limits
+#include <algorithm>    // For std::min, std::move, std::rotate
+#include <cstring>      // For std::memcpy
+#include <iterator>     // For std::forward_iterator_tag
+#include <type_traits>  // For std::is_trivially_copyable_v, std::is_nothrow_move_assignable_v
+
+#include "ringbuff_sort.hpp"
 
 // A simple fixed-size ring buffer (circular queue) implementation.
 // This class provides a basic ring buffer that allows elements to be added
@@ -75,6 +85,62 @@ public:
     // Clears the buffer, making it empty.
     void clear();
 
+    // Returns the live elements as two contiguous spans, oldest first.
+    // The second span is empty unless the contents wrap around the end of storage.
+    std::pair<std::span<const T>, std::span<const T>> segments() const;
+
+    // Returns the unused slots after the newest element as two contiguous spans,
+    // in the order they will be filled. Write into them, then call commit().
+    std::pair<std::span<T>, std::span<T>> free_segments();
+
+    // Appends the next `count` slots of free_segments() as elements.
+    // Throws std::out_of_range if count exceeds the free space.
+    void commit(size_t count);
+
+    // Removes the `count` oldest elements without returning them.
+    // Throws std::out_of_range if count exceeds the number of elements.
+    void discard(size_t count);
+
+    // Removes up to max_count of the oldest elements, passing each to fn as an
+    // rvalue, oldest first, and returns how many were removed.
+    // If fn throws, the elements it already accepted are removed and the exception propagates.
+    template <typename Fn>
+    size_t consume(Fn&& fn, size_t max_count = std::numeric_limits<size_t>::max());
+
+    // Moves up to out.size() of the oldest elements into out, oldest first,
+    // and returns how many were removed.
+    size_t pop_bulk(std::span<T> out);
+
+    // Returns a copy of the elements in ascending order. Integers and
+    // floating-point values are radix sorted; see ringbuff_sort.hpp.
+    std::vector<T> sorted_copy() const;
+
+    // Returns a copy of the element that would be at index k of sorted_copy(),
+    // in O(size()) on average. Throws std::out_of_range if k >= size().
+    T nth_element_copy(size_t k) const;
+
+    // Sorts the elements in place, oldest becoming smallest. Contents that
+    // wrap around the end of storage are first rotated into one run.
+    void sort();
+
+    // Returns a pointer to the underlying storage of capacity() elements.
+    const T* data() const;
+
+    // Enables or disables the snapshot version counter.
+    // While enabled, every mutation costs two extra stores and no locks.
+    // Must not be toggled while another thread is taking snapshots.
+    void enable_snapshots(bool enabled = true);
+
+    // Copies the live elements, oldest first, into out from another thread.
+    // Retries up to max_retries times if the owner mutates the buffer mid-copy.
+    // Returns true if a consistent copy was taken, false if every attempt raced
+    // with a writer or snapshots are disabled. Requires a trivially copyable T.
+    // Writes made through at() or iterators are not tracked by the version counter.
+    // head_ and size_ are read from atomic copies the owner publishes. The
+    // elements are copied with memcpy, as in any sequence lock, and a copy that
+    // overlapped a write is discarded.
+    bool try_snapshot(std::vector<T>& out, size_t max_retries = 16) const;
+
     // Iterator support:
     // This nested class allows RingBuffer to be used with range-based for loops.
     class RingBufferIterator {
@@ -101,9 +167,13 @@ public:
         RingBufferIterator operator++(int);
 
         // Equality comparison
-        friend bool operator==(const RingBufferIterator& a, const RingBufferIterator& b);
+        friend bool operator==(const RingBufferIterator& a, const RingBufferIterator& b) {
+            return a.current_logical_index_ == b.current_logical_index_;
+        }
         // Inequality comparison
-        friend bool operator!=(const RingBufferIterator& a, const RingBufferIterator& b);
+        friend bool operator!=(const RingBufferIterator& a, const RingBufferIterator& b) {
+            return !(a == b);
+        }
 
     private:
         T* data_ptr_;                 // Pointer to the start of the underlying std::vector's data
@@ -136,6 +206,430 @@ private:
     size_t head_;             // Index of the oldest element (next to be read)
     size_t tail_;             // Index of the next available slot (next to be written)
     size_t size_;             // Current number of elements in the buffer
+
+    // Snapshot sequence lock: odd while a mutation is in progress.
+    alignas(std::atomic_ref<uint64_t>::required_alignment) uint64_t version_ = 0;
+    bool snapshots_ = false;  // Whether mutations maintain version_
+
+    // head_ and size_ as published by end_write(). Snapshot readers load these
+    // through atomic_ref instead of the owner's plain fields.
+    alignas(std::atomic_ref<size_t>::required_alignment) size_t snapshot_head_ = 0;
+    alignas(std::atomic_ref<size_t>::required_alignment) size_t snapshot_size_ = 0;
+
+    // Marks the start and end of a mutation for concurrent snapshot readers.
+    void begin_write();
+    void end_write();
+    void publish_position();
 };
 
+// Bit-packed flags with a running count of true flags. Defined in
+// ringbuff_packed.hpp, which the end of this header includes, so every
+// translation unit sees the same RingBuffer<bool>.
+template <>
+class RingBuffer<bool>;
+
+template <typename T>
+RingBuffer<T>::RingBuffer(size_t capacity)
+    : buffer_(capacity), capacity_(capacity), head_(0), tail_(0), size_(0) {
+    if (capacity == 0) {
+        throw std::invalid_argument("RingBuffer capacity must be greater than 0.");
+    }
+}
+
+template <typename T>
+void RingBuffer<T>::push(const T& item) {
+    begin_write();
+    buffer_[tail_] = item;
+    tail_ = (tail_ + 1) % capacity_;
+
+    if (size_ < capacity_) {
+        size_++;
+    } else {
+        head_ = (head_ + 1) % capacity_;
+    }
+    end_write();
+}
+
+template <typename T>
+void RingBuffer<T>::push(T&& item) {
+    begin_write();
+    buffer_[tail_] = std::move(item);
+    tail_ = (tail_ + 1) % capacity_;
+
+    if (size_ < capacity_) {
+        size_++;
+    } else {
+        head_ = (head_ + 1) % capacity_;
+    }
+    end_write();
+}
+
+template <typename T>
+template <typename... Args>
+void RingBuffer<T>::emplace(Args&&... args) {
+    begin_write();
+    buffer_[tail_] = T(std::forward<Args>(args)...);
+    tail_ = (tail_ + 1) % capacity_;
+
+    if (size_ < capacity_) {
+        size_++;
+    } else {
+        head_ = (head_ + 1) % capacity_;
+    }
+    end_write();
+}
+
+template <typename T>
+bool RingBuffer<T>::try_push(const T& item) {
+    if (full()) {
+        return false;
+    }
+    push(item);
+    return true;
+}
+
+template <typename T>
+bool RingBuffer<T>::try_push(T&& item) {
+    if (full()) {
+        return false;
+    }
+    push(std::move(item));
+    return true;
+}
+
+template <typename T>
+T RingBuffer<T>::pop() {
+    if (empty()) {
+        throw std::out_of_range("Cannot pop from an empty RingBuffer.");
+    }
+
+    begin_write();
+    T item = std::move(buffer_[head_]);
+    head_ = (head_ + 1) % capacity_;
+    size_--;
+    end_write();
+    return item;
+}
+
+template <typename T>
+bool RingBuffer<T>::try_pop(T& out_item) {
+    if (empty()) {
+        return false;
+    }
+    begin_write();
+    out_item = std::move(buffer_[head_]);
+    head_ = (head_ + 1) % capacity_;
+    size_--;
+    end_write();
+    return true;
+}
+
+template <typename T>
+const T& RingBuffer<T>::front() const {
+    if (empty()) {
+        throw std::out_of_range("Cannot get front from an empty RingBuffer.");
+    }
+    return buffer_[head_];
+}
+
+template <typename T>
+T& RingBuffer<T>::at(size_t index) {
+    if (index >= size_) {
+        throw std::out_of_range("Index out of bounds for RingBuffer::at()");
+    }
+    return buffer_[(head_ + index) % capacity_];
+}
+
+template <typename T>
+const T& RingBuffer<T>::at(size_t index) const {
+    if (index >= size_) {
+        throw std::out_of_range("Index out of bounds for RingBuffer::at() const");
+    }
+    return buffer_[(head_ + index) % capacity_];
+}
+
+template <typename T>
+bool RingBuffer<T>::empty() const {
+    return size_ == 0;
+}
+
+template <typename T>
+bool RingBuffer<T>::full() const {
+    return size_ == capacity_;
+}
+
+template <typename T>
+size_t RingBuffer<T>::size() const {
+    return size_;
+}
+
+template <typename T>
+size_t RingBuffer<T>::capacity() const {
+    return capacity_;
+}
+
+template <typename T>
+void RingBuffer<T>::clear() {
+    begin_write();
+    head_ = 0;
+    tail_ = 0;
+    size_ = 0;
+    end_write();
+}
+
+template <typename T>
+std::pair<std::span<const T>, std::span<const T>> RingBuffer<T>::segments() const {
+    const size_t first = std::min(size_, capacity_ - head_);
+    return {std::span<const T>(buffer_.data() + head_, first),
+            std::span<const T>(buffer_.data(), size_ - first)};
+}
+
+template <typename T>
+std::pair<std::span<T>, std::span<T>> RingBuffer<T>::free_segments() {
+    const size_t free = capacity_ - size_;
+    const size_t first = std::min(free, capacity_ - tail_);
+    return {std::span<T>(buffer_.data() + tail_, first),
+            std::span<T>(buffer_.data(), free - first)};
+}
+
+template <typename T>
+void RingBuffer<T>::commit(size_t count) {
+    if (count > capacity_ - size_) {
+        throw std::out_of_range("Cannot commit more elements than the RingBuffer has free slots.");
+    }
+    begin_write();
+    tail_ = (tail_ + count) % capacity_;
+    size_ += count;
+    end_write();
+}
+
+template <typename T>
+void RingBuffer<T>::discard(size_t count) {
+    if (count > size_) {
+        throw std::out_of_range("Cannot discard more elements than the RingBuffer holds.");
+    }
+    begin_write();
+    head_ = (head_ + count) % capacity_;
+    size_ -= count;
+    end_write();
+}
+
+template <typename T>
+template <typename Fn>
+size_t RingBuffer<T>::consume(Fn&& fn, size_t max_count) {
+    const size_t count = std::min(size_, max_count);
+    size_t done = 0;
+    begin_write();
+    try {
+        for (; done < count; ++done) {
+            fn(std::move(buffer_[head_]));
+            head_ = head_ + 1 == capacity_ ? 0 : head_ + 1;
+        }
+    } catch (...) {
+        size_ -= done;
+        end_write();
+        throw;
+    }
+    size_ -= count;
+    end_write();
+    return count;
+}
+
+template <typename T>
+size_t RingBuffer<T>::pop_bulk(std::span<T> out) {
+    if constexpr (!std::is_nothrow_move_assignable_v<T>) {
+        size_t done = 0;
+        return consume([&](T&& item) { out[done++] = std::move(item); }, out.size());
+    } else {
+        const size_t count = std::min(size_, out.size());
+        const size_t first = std::min(count, capacity_ - head_);
+        begin_write();
+        std::move(buffer_.begin() + head_, buffer_.begin() + head_ + first, out.begin());
+        std::move(buffer_.begin(), buffer_.begin() + (count - first), out.begin() + first);
+        head_ = (head_ + count) % capacity_;
+        size_ -= count;
+        end_write();
+        return count;
+    }
+}
+
+template <typename T>
+std::vector<T> RingBuffer<T>::sorted_copy() const {
+    std::vector<T> out;
+    out.reserve(size_);
+    const auto [first, second] = segments();
+    out.insert(out.end(), first.begin(), first.end());
+    out.insert(out.end(), second.begin(), second.end());
+    ring_sort::sort(std::span<T>(out));
+    return out;
+}
+
+template <typename T>
+T RingBuffer<T>::nth_element_copy(size_t k) const {
+    if (k >= size_) {
+        throw std::out_of_range("Index out of bounds for RingBuffer::nth_element_copy()");
+    }
+    std::vector<T> out;
+    out.reserve(size_);
+    const auto [first, second] = segments();
+    out.insert(out.end(), first.begin(), first.end());
+    out.insert(out.end(), second.begin(), second.end());
+    ring_sort::nth_element(std::span<T>(out), k);
+    return std::move(out[k]);
+}
+
+template <typename T>
+void RingBuffer<T>::sort() {
+    begin_write();
+    try {
+        if (head_ + size_ > capacity_) {
+            std::rotate(buffer_.begin(), buffer_.begin() + head_, buffer_.end());
+            head_ = 0;
+            tail_ = size_ % capacity_;
+        }
+        ring_sort::sort(std::span<T>(buffer_.data() + head_, size_));
+    } catch (...) {
+        end_write();
+        throw;
+    }
+    end_write();
+}
+
+template <typename T>
+const T* RingBuffer<T>::data() const {
+    return buffer_.data();
+}
+
+template <typename T>
+void RingBuffer<T>::enable_snapshots(bool enabled) {
+    snapshots_ = enabled;
+    if (enabled) {
+        publish_position();
+    }
+}
+
+template <typename T>
+bool RingBuffer<T>::try_snapshot(std::vector<T>& out, size_t max_retries) const {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "RingBuffer::try_snapshot requires a trivially copyable T");
+    if (!snapshots_) {
+        return false;
+    }
+
+    // Seqlock read side: a copy is only kept if the version was even and
+    // unchanged across it, so torn reads of a mutating buffer are discarded.
+    std::atomic_ref<uint64_t> version(const_cast<uint64_t&>(version_));
+    for (size_t attempt = 0; attempt < max_retries; ++attempt) {
+        const uint64_t before = version.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;
+        }
+        const size_t head =
+            std::atomic_ref<size_t>(const_cast<size_t&>(snapshot_head_)).load(std::memory_order_relaxed);
+        const size_t size =
+            std::atomic_ref<size_t>(const_cast<size_t&>(snapshot_size_)).load(std::memory_order_relaxed);
+        if (head >= capacity_ || size > capacity_) {
+            continue;
+        }
+
+        const size_t first = std::min(size, capacity_ - head);
+        out.resize(size);
+        std::memcpy(static_cast<void*>(out.data()), buffer_.data() + head, first * sizeof(T));
+        std::memcpy(static_cast<void*>(out.data() + first), buffer_.data(), (size - first) * sizeof(T));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (version.load(std::memory_order_relaxed) == before) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename T>
+RingBuffer<T>::RingBufferIterator::RingBufferIterator(T* data_ptr, size_t current_logical_index, size_t buffer_head,
+                                                      size_t buffer_capacity)
+    : data_ptr_(data_ptr),
+      current_logical_index_(current_logical_index),
+      buffer_head_(buffer_head),
+      buffer_capacity_(buffer_capacity) {}
+
+template <typename T>
+typename RingBuffer<T>::RingBufferIterator::reference RingBuffer<T>::RingBufferIterator::operator*() const {
+    return data_ptr_[(buffer_head_ + current_logical_index_) % buffer_capacity_];
+}
+
+template <typename T>
+typename RingBuffer<T>::RingBufferIterator::pointer RingBuffer<T>::RingBufferIterator::operator->() const {
+    return &data_ptr_[(buffer_head_ + current_logical_index_) % buffer_capacity_];
+}
+
+template <typename T>
+typename RingBuffer<T>::RingBufferIterator& RingBuffer<T>::RingBufferIterator::operator++() {
+    current_logical_index_++;
+    return *this;
+}
+
+template <typename T>
+typename RingBuffer<T>::RingBufferIterator RingBuffer<T>::RingBufferIterator::operator++(int) {
+    RingBufferIterator tmp = *this;
+    ++(*this);
+    return tmp;
+}
+
+template <typename T>
+typename RingBuffer<T>::RingBufferIterator RingBuffer<T>::begin() {
+    return RingBufferIterator(buffer_.data(), 0, head_, capacity_);
+}
+
+template <typename T>
+typename RingBuffer<T>::RingBufferIterator RingBuffer<T>::begin() const {
+    return RingBufferIterator(const_cast<T*>(buffer_.data()), 0, head_, capacity_);
+}
+
+template <typename T>
+typename RingBuffer<T>::RingBufferIterator RingBuffer<T>::end() {
+    return RingBufferIterator(buffer_.data(), size_, head_, capacity_);
+}
+
+template <typename T>
+typename RingBuffer<T>::RingBufferIterator RingBuffer<T>::end() const {
+    return RingBufferIterator(const_cast<T*>(buffer_.data()), size_, head_, capacity_);
+}
+
+template <typename T>
+typename RingBuffer<T>::RingBufferIterator RingBuffer<T>::cbegin() const {
+    return RingBufferIterator(const_cast<T*>(buffer_.data()), 0, head_, capacity_);
+}
+
+template <typename T>
+typename RingBuffer<T>::RingBufferIterator RingBuffer<T>::cend() const {
+    return RingBufferIterator(const_cast<T*>(buffer_.data()), size_, head_, capacity_);
+}
+
+template <typename T>
+void RingBuffer<T>::begin_write() {
+    if (snapshots_) {
+        std::atomic_ref<uint64_t> version(version_);
+        version.store(version.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+}
+
+template <typename T>
+void RingBuffer<T>::end_write() {
+    if (snapshots_) {
+        publish_position();
+        std::atomic_ref<uint64_t> version(version_);
+        version.store(version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+}
+
+template <typename T>
+void RingBuffer<T>::publish_position() {
+    std::atomic_ref<size_t>(snapshot_head_).store(head_, std::memory_order_relaxed);
+    std::atomic_ref<size_t>(snapshot_size_).store(size_, std::memory_order_relaxed);
+}
+
+#include "ringbuff_packed.hpp"
+
 #endif // RING_BUFFER_HPP
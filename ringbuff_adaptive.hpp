@@ -0,0 +1,115 @@
+#ifndef RING_BUFFER_ADAPTIVE_HPP
+#define RING_BUFFER_ADAPTIVE_HPP
+
+#include <algorithm>  // For std::clamp, std::max, std::min
+#include <chrono>     // For std::chrono::nanoseconds, std::chrono::microseconds
+#include <cstddef>    // For size_t
+#include <cstdint>    // For uint64_t
+#include <stdexcept>  // For std::invalid_argument
+#include <utility>    // For std::forward
+
+#include "ringbuff_clock.hpp"
+
+// Settings for AdaptiveConsumer.
+struct AdaptiveBatchOptions {
+    size_t min_batch = 1;                              // Smallest batch limit
+    size_t max_batch = 4096;                           // Largest batch limit
+    size_t initial_batch = 32;                         // Limit used for the first batch
+    size_t increase_step = 16;                         // Additive growth while a backlog persists
+    double decrease_factor = 0.5;                      // Multiplicative cut when a batch runs over budget
+    std::chrono::nanoseconds latency_budget{std::chrono::microseconds(200)};  // Longest acceptable batch
+};
+
+// Drains a ring in batches whose size follows the load, using an AIMD
+// (additive increase, multiplicative decrease) controller.
+// While a backlog remains after a full batch, the batch limit grows by
+// increase_step, amortizing per-batch overhead under load. Whenever a batch
+// takes longer than latency_budget, the limit is cut by decrease_factor, so
+// the last element of a batch never waits much longer than the budget. When
+// the ring runs dry, the limit drifts back down so a burst after an idle
+// period starts with short, low-latency batches.
+// Ring is any ring with size() and consume(fn, max_count), such as RingBuffer<T>.
+template <typename Ring>
+class AdaptiveConsumer {
+public:
+    // Throws std::invalid_argument if the options are inconsistent.
+    explicit AdaptiveConsumer(Ring& ring, AdaptiveBatchOptions options = {});
+
+    // Consumes one batch of at most batch_limit() elements with fn, then adjusts
+    // the limit. Returns the number of elements consumed.
+    template <typename Fn>
+    size_t poll(Fn&& fn);
+
+    // Returns the limit the next batch will use.
+    size_t batch_limit() const;
+
+    // Returns the number of non-empty batches consumed so far.
+    uint64_t batches() const;
+
+    // Returns the number of elements consumed so far.
+    uint64_t consumed() const;
+
+private:
+    Ring& ring_;
+    AdaptiveBatchOptions options_;
+    uint64_t budget_ticks_;  // latency_budget in TscClock ticks
+    size_t limit_;
+    uint64_t batches_ = 0;
+    uint64_t consumed_ = 0;
+};
+
+template <typename Ring>
+AdaptiveConsumer<Ring>::AdaptiveConsumer(Ring& ring, AdaptiveBatchOptions options)
+    : ring_(ring), options_(options), limit_(options.initial_batch) {
+    if (options_.min_batch == 0 || options_.min_batch > options_.max_batch) {
+        throw std::invalid_argument("AdaptiveConsumer needs 0 < min_batch <= max_batch.");
+    }
+    if (options_.decrease_factor <= 0.0 || options_.decrease_factor >= 1.0) {
+        throw std::invalid_argument("AdaptiveConsumer decrease factor must be between 0 and 1.");
+    }
+    limit_ = std::clamp(limit_, options_.min_batch, options_.max_batch);
+    budget_ticks_ = static_cast<uint64_t>(static_cast<double>(options_.latency_budget.count()) *
+                                          TscClock::process().ticks_per_second() / 1e9);
+}
+
+template <typename Ring>
+template <typename Fn>
+size_t AdaptiveConsumer<Ring>::poll(Fn&& fn) {
+    const uint64_t start = TscClock::now();
+    const size_t count = ring_.consume(std::forward<Fn>(fn), limit_);
+    const uint64_t elapsed = TscClock::now() - start;
+    if (count == 0) {
+        return 0;
+    }
+    ++batches_;
+    consumed_ += count;
+
+    if (elapsed > budget_ticks_) {
+        // Over budget: back off quickly.
+        limit_ = std::max(options_.min_batch, static_cast<size_t>(static_cast<double>(limit_) * options_.decrease_factor));
+    } else if (count == limit_ && ring_.size() > 0) {
+        // Full batch and still a backlog: probe for more throughput.
+        limit_ = std::min(options_.max_batch, limit_ + options_.increase_step);
+    } else if (count < limit_) {
+        // The ring ran dry: drift back toward short batches.
+        limit_ = std::max(options_.min_batch, std::max(count, limit_ - std::min(limit_, options_.increase_step)));
+    }
+    return count;
+}
+
+template <typename Ring>
+size_t AdaptiveConsumer<Ring>::batch_limit() const {
+    return limit_;
+}
+
+template <typename Ring>
+uint64_t AdaptiveConsumer<Ring>::batches() const {
+    return batches_;
+}
+
+template <typename Ring>
+uint64_t AdaptiveConsumer<Ring>::consumed() const {
+    return consumed_;
+}
+
+#endif // RING_BUFFER_ADAPTIVE_HPP
@@ -0,0 +1,323 @@
+#include "ringbuff_affinity.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+bool read_line(const std::filesystem::path& path, std::string& out) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    std::getline(in, out);
+    return static_cast<bool>(in) || !out.empty();
+}
+
+int read_int(const std::filesystem::path& path, int fallback) {
+    std::string line;
+    if (!read_line(path, line)) {
+        return fallback;
+    }
+    try {
+        return std::stoi(line);
+    } catch (const std::exception&) {
+        return fallback;
+    }
+}
+
+// The lowest CPU in a sharing set identifies the whole set.
+int first_cpu_in(const std::filesystem::path& path) {
+    std::string line;
+    if (!read_line(path, line)) {
+        return -1;
+    }
+    try {
+        std::vector<int> cpus = parse_cpu_list(line);
+        return cpus.empty() ? -1 : *std::min_element(cpus.begin(), cpus.end());
+    } catch (const std::invalid_argument&) {
+        return -1;
+    }
+}
+
+CpuInfo read_cpu(const std::filesystem::path& root, int cpu) {
+    namespace fs = std::filesystem;
+    const fs::path dir = root / ("cpu" + std::to_string(cpu));
+
+    CpuInfo info;
+    info.cpu = cpu;
+    info.core = read_int(dir / "topology" / "core_id", -1);
+    info.package = read_int(dir / "topology" / "physical_package_id", -1);
+
+    std::error_code ec;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        const std::string name = it->path().filename().string();
+        if (name.size() > 4 && name.compare(0, 4, "node") == 0) {
+            try {
+                info.numa_node = std::stoi(name.substr(4));
+            } catch (const std::exception&) {
+            }
+        }
+    }
+
+    for (int index = 0;; ++index) {
+        const fs::path cache = dir / "cache" / ("index" + std::to_string(index));
+        if (!fs::exists(cache, ec)) {
+            break;
+        }
+        std::string type;
+        if (read_line(cache / "type", type) && type == "Instruction") {
+            continue;
+        }
+        const int level = read_int(cache / "level", 0);
+        if (level == 2) {
+            info.l2_group = first_cpu_in(cache / "shared_cpu_list");
+        } else if (level == 3) {
+            info.l3_group = first_cpu_in(cache / "shared_cpu_list");
+        }
+    }
+    return info;
+}
+
+}  // namespace
+
+std::vector<int> parse_cpu_list(const std::string& list) {
+    std::vector<int> cpus;
+    size_t pos = 0;
+    while (pos < list.size()) {
+        size_t comma = list.find(',', pos);
+        if (comma == std::string::npos) {
+            comma = list.size();
+        }
+        std::string range = list.substr(pos, comma - pos);
+        while (!range.empty() && (range.back() == '\n' || range.back() == ' ')) {
+            range.pop_back();
+        }
+        if (!range.empty()) {
+            try {
+                const size_t dash = range.find('-');
+                const int first = std::stoi(range.substr(0, dash));
+                const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                if (first < 0 || last < first) {
+                    throw std::invalid_argument(range);
+                }
+                for (int cpu = first; cpu <= last; ++cpu) {
+                    cpus.push_back(cpu);
+                }
+            } catch (const std::logic_error&) {
+                throw std::invalid_argument("Malformed CPU list: " + list);
+            }
+        }
+        pos = comma + 1;
+    }
+    return cpus;
+}
+
+CpuTopology CpuTopology::discover(const std::string& sysfs_root) {
+    const std::filesystem::path root(sysfs_root);
+    std::string online;
+    if (!read_line(root / "online", online)) {
+        throw std::runtime_error("Cannot read online CPUs from " + (root / "online").string());
+    }
+
+    std::vector<CpuInfo> cpus;
+    for (int cpu : parse_cpu_list(online)) {
+        cpus.push_back(read_cpu(root, cpu));
+    }
+    return CpuTopology(std::move(cpus));
+}
+
+CpuTopology::CpuTopology(std::vector<CpuInfo> cpus) : cpus_(std::move(cpus)) {
+    std::sort(cpus_.begin(), cpus_.end(),
+              [](const CpuInfo& a, const CpuInfo& b) { return a.cpu < b.cpu; });
+}
+
+const std::vector<CpuInfo>& CpuTopology::cpus() const {
+    return cpus_;
+}
+
+const CpuInfo& CpuTopology::info(int cpu) const {
+    auto it = std::lower_bound(cpus_.begin(), cpus_.end(), cpu,
+                               [](const CpuInfo& info, int value) { return info.cpu < value; });
+    if (it == cpus_.end() || it->cpu != cpu) {
+        throw std::out_of_range("CPU is not part of the topology");
+    }
+    return *it;
+}
+
+CpuSharing CpuTopology::sharing(int a, int b) const {
+    const CpuInfo& x = info(a);
+    const CpuInfo& y = info(b);
+    if (x.cpu == y.cpu) {
+        return CpuSharing::Same;
+    }
+    if (x.package == y.package && x.core == y.core && x.core >= 0) {
+        return CpuSharing::Core;
+    }
+    if (x.l2_group >= 0 && x.l2_group == y.l2_group) {
+        return CpuSharing::L2;
+    }
+    if (x.l3_group >= 0 && x.l3_group == y.l3_group) {
+        return CpuSharing::L3;
+    }
+    if (x.package >= 0 && x.package == y.package) {
+        return CpuSharing::Package;
+    }
+    if (x.numa_node >= 0 && x.numa_node == y.numa_node) {
+        return CpuSharing::Node;
+    }
+    return CpuSharing::Remote;
+}
+
+std::vector<std::pair<int, int>> CpuTopology::place_pairs(size_t count, bool allow_smt_siblings) const {
+    std::vector<std::tuple<CpuSharing, int, int>> candidates;
+    for (size_t i = 0; i < cpus_.size(); ++i) {
+        for (size_t j = i + 1; j < cpus_.size(); ++j) {
+            const CpuSharing level = sharing(cpus_[i].cpu, cpus_[j].cpu);
+            if (level == CpuSharing::Core && !allow_smt_siblings) {
+                continue;
+            }
+            candidates.emplace_back(level, cpus_[i].cpu, cpus_[j].cpu);
+        }
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const auto& a, const auto& b) { return std::get<0>(a) < std::get<0>(b); });
+
+    std::vector<int> used;
+    std::vector<std::pair<int, int>> pairs;
+    for (const auto& [level, a, b] : candidates) {
+        if (pairs.size() == count) {
+            break;
+        }
+        if (std::find(used.begin(), used.end(), a) != used.end() ||
+            std::find(used.begin(), used.end(), b) != used.end()) {
+            continue;
+        }
+        used.push_back(a);
+        used.push_back(b);
+        pairs.emplace_back(a, b);
+    }
+    return pairs;
+}
+
+bool pin_current_thread(int cpu) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+bool pin_thread(std::thread& thread, int cpu) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE || !thread.joinable()) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+}
+
+double HandoffMatrix::at(size_t from, size_t to) const {
+    if (from >= cpus.size() || to >= cpus.size()) {
+        throw std::out_of_range("Index out of bounds for HandoffMatrix::at()");
+    }
+    return latency_ns[from * cpus.size() + to];
+}
+
+namespace {
+
+// Ping and pong live on separate cache lines so that each hand-off moves
+// exactly one line from the writer's core to the reader's core.
+struct alignas(64) PaddedCounter {
+    std::atomic<uint64_t> value{0};
+};
+
+// Restores the calling thread's CPU mask on scope exit, including when a
+// measurement throws after the thread was pinned.
+class AffinityRestorer {
+public:
+    AffinityRestorer() : saved_(pthread_getaffinity_np(pthread_self(), sizeof(mask_), &mask_) == 0) {}
+    ~AffinityRestorer() {
+        if (saved_) {
+            pthread_setaffinity_np(pthread_self(), sizeof(mask_), &mask_);
+        }
+    }
+    AffinityRestorer(const AffinityRestorer&) = delete;
+    AffinityRestorer& operator=(const AffinityRestorer&) = delete;
+
+private:
+    cpu_set_t mask_;
+    bool saved_;
+};
+
+double measure_pair(int from, int to, size_t round_trips) {
+    PaddedCounter ping;
+    PaddedCounter pong;
+    std::atomic<bool> pinned_ok{true};
+
+    std::thread responder([&] {
+        if (!pin_current_thread(to)) {
+            pinned_ok.store(false, std::memory_order_relaxed);
+        }
+        for (uint64_t i = 1; i <= round_trips; ++i) {
+            while (ping.value.load(std::memory_order_acquire) != i) {
+            }
+            pong.value.store(i, std::memory_order_release);
+        }
+    });
+
+    if (!pin_current_thread(from)) {
+        pinned_ok.store(false, std::memory_order_relaxed);
+    }
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 1; i <= round_trips; ++i) {
+        ping.value.store(i, std::memory_order_release);
+        while (pong.value.load(std::memory_order_acquire) != i) {
+        }
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    responder.join();
+
+    if (!pinned_ok.load(std::memory_order_relaxed)) {
+        throw std::runtime_error("Cannot pin hand-off benchmark thread");
+    }
+    const double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+    return ns / static_cast<double>(round_trips) / 2.0;
+}
+
+}  // namespace
+
+HandoffMatrix measure_handoff_matrix(const std::vector<int>& cpus, size_t round_trips) {
+    if (round_trips == 0) {
+        throw std::invalid_argument("Hand-off benchmark needs at least one round trip.");
+    }
+
+    HandoffMatrix matrix;
+    matrix.cpus = cpus;
+    matrix.latency_ns.assign(cpus.size() * cpus.size(), 0.0);
+
+    const AffinityRestorer restorer;
+    for (size_t i = 0; i < cpus.size(); ++i) {
+        for (size_t j = 0; j < cpus.size(); ++j) {
+            if (i != j && cpus[i] != cpus[j]) {
+                matrix.latency_ns[i * cpus.size() + j] = measure_pair(cpus[i], cpus[j], round_trips);
+            }
+        }
+    }
+    return matrix;
+}
@@ -0,0 +1,97 @@
+#ifndef RING_BUFFER_AFFINITY_HPP
+#define RING_BUFFER_AFFINITY_HPP
+
+#include <cstddef>    // For size_t
+#include <string>     // For std::string
+#include <thread>     // For std::thread
+#include <utility>    // For std::pair
+#include <vector>     // For std::vector
+
+// CPU topology discovery and thread pinning helpers.
+// Ring hand-off latency depends heavily on which cache level the producer and
+// consumer cores share, so these utilities let benchmarks and pipelines place
+// their threads deliberately instead of leaving it to the scheduler.
+
+// How closely two logical CPUs are coupled, ordered from closest to farthest.
+enum class CpuSharing {
+    Same,     // The same logical CPU
+    Core,     // SMT siblings on one physical core
+    L2,       // Distinct cores sharing an L2 cache
+    L3,       // Distinct cores sharing an L3 cache
+    Package,  // The same socket without a shared cache
+    Node,     // The same NUMA node on different sockets
+    Remote    // Different sockets and NUMA nodes
+};
+
+// Topology of a single logical CPU as reported by sysfs.
+// Group identifiers are the lowest CPU number in the sharing set, or -1 if unknown.
+struct CpuInfo {
+    int cpu = -1;        // Logical CPU number as seen by the scheduler
+    int core = -1;       // Physical core id within the package
+    int package = -1;    // Physical package (socket) id
+    int numa_node = -1;  // NUMA node the CPU belongs to
+    int l2_group = -1;   // Group of CPUs sharing this CPU's L2 cache
+    int l3_group = -1;   // Group of CPUs sharing this CPU's L3 cache
+};
+
+// A snapshot of the online CPUs and their cache/NUMA relationships.
+class CpuTopology {
+public:
+    // Reads the topology of the online CPUs from sysfs.
+    // The root is configurable so that captured sysfs trees can be replayed.
+    // Throws std::runtime_error if the list of online CPUs cannot be read.
+    static CpuTopology discover(const std::string& sysfs_root = "/sys/devices/system/cpu");
+
+    // Builds a topology from already known CPU descriptions.
+    explicit CpuTopology(std::vector<CpuInfo> cpus);
+
+    // Returns all online CPUs, ordered by CPU number.
+    const std::vector<CpuInfo>& cpus() const;
+
+    // Returns the description of the given logical CPU.
+    // Throws std::out_of_range if the CPU is not part of the topology.
+    const CpuInfo& info(int cpu) const;
+
+    // Classifies how closely two logical CPUs are coupled.
+    // Throws std::out_of_range if either CPU is not part of the topology.
+    CpuSharing sharing(int a, int b) const;
+
+    // Chooses up to `count` disjoint (producer, consumer) CPU pairs, closest pairs first.
+    // SMT siblings are only paired when allow_smt_siblings is true, since they
+    // compete for the same execution resources.
+    std::vector<std::pair<int, int>> place_pairs(size_t count, bool allow_smt_siblings = false) const;
+
+private:
+    std::vector<CpuInfo> cpus_;  // Online CPUs, ordered by CPU number
+};
+
+// Parses a sysfs CPU list such as "0-3,8,10-11".
+// Throws std::invalid_argument on malformed input.
+std::vector<int> parse_cpu_list(const std::string& list);
+
+// Pins the calling thread to a single logical CPU.
+// Returns true if successful, false if the operating system refused.
+bool pin_current_thread(int cpu);
+
+// Pins a running std::thread to a single logical CPU.
+// Returns true if successful, false if the operating system refused.
+bool pin_thread(std::thread& thread, int cpu);
+
+// One-way hand-off latencies between every ordered pair of CPUs.
+struct HandoffMatrix {
+    std::vector<int> cpus;           // CPUs in row/column order
+    std::vector<double> latency_ns;  // Row-major, latency_ns[i * cpus.size() + j]
+
+    // Returns the latency of handing data from cpus[from] to cpus[to].
+    // Throws std::out_of_range if either index is out of bounds.
+    double at(size_t from, size_t to) const;
+};
+
+// Measures the one-way hand-off latency for every ordered pair of the given CPUs.
+// Each pair ping-pongs a cache line `round_trips` times between two pinned
+// threads, which is the cost a ring pays per published element when producer
+// and consumer run in lockstep. The diagonal is reported as 0.
+// Throws std::runtime_error if a thread cannot be pinned.
+HandoffMatrix measure_handoff_matrix(const std::vector<int>& cpus, size_t round_trips = 100000);
+
+#endif // RING_BUFFER_AFFINITY_HPP
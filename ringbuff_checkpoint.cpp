@@ -0,0 +1,139 @@
+#include "ringbuff_checkpoint.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "ringbuff_crc32c.hpp"
+#include "ringbuff_lz4.hpp"
+
+namespace {
+
+// Per-block header. The top bit of stored_bytes marks a block kept uncompressed.
+struct BlockHeader {
+    uint32_t raw_bytes;
+    uint32_t stored_bytes;
+    uint32_t crc;
+};
+
+constexpr uint32_t raw_flag = 0x80000000u;
+
+// Upper bound on raw bytes per stored byte: each LZ4 length byte adds at most 255.
+constexpr uint64_t max_expansion = 256;
+
+uint32_t header_crc(const CheckpointHeader& header) {
+    return crc32c(&header, offsetof(CheckpointHeader, crc));
+}
+
+// Bytes left in a seekable stream, or -1 if it cannot seek.
+std::streamoff remaining_bytes(std::istream& in) {
+    const std::streampos here = in.tellg();
+    if (here == std::streampos(-1) || !in.seekg(0, std::ios::end)) {
+        in.clear();
+        return -1;
+    }
+    const std::streampos end = in.tellg();
+    in.seekg(here);
+    return end == std::streampos(-1) ? -1 : end - here;
+}
+
+void write_bytes(std::ostream& out, const void* data, size_t size) {
+    if (!out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size))) {
+        throw std::runtime_error("Checkpoint write failed.");
+    }
+}
+
+void read_bytes(std::istream& in, void* data, size_t size) {
+    if (!in.read(static_cast<char*>(data), static_cast<std::streamsize>(size))) {
+        throw std::runtime_error("Checkpoint truncated.");
+    }
+}
+
+}  // namespace
+
+void write_checkpoint(std::ostream& out, const CheckpointHeader& header, std::span<const std::byte> first,
+                      std::span<const std::byte> second, const CheckpointOptions& options) {
+    if (options.block_bytes == 0 || options.block_bytes >= raw_flag) {
+        throw std::invalid_argument("Checkpoint block size must be between 1 byte and 2 GiB.");
+    }
+    CheckpointHeader sealed = header;
+    sealed.crc = header_crc(sealed);
+    sealed.reserved = 0;
+    write_bytes(out, &sealed, sizeof(sealed));
+
+    std::vector<std::byte> compressed(options.compress ? lz4_compress_bound(options.block_bytes) : 0);
+    for (const std::span<const std::byte> segment : {first, second}) {
+        for (size_t offset = 0; offset < segment.size(); offset += options.block_bytes) {
+            const std::span<const std::byte> raw =
+                segment.subspan(offset, std::min(options.block_bytes, segment.size() - offset));
+            BlockHeader block{static_cast<uint32_t>(raw.size()), 0, crc32c(raw.data(), raw.size())};
+            // Keep the compressed form only if it saves space.
+            const size_t packed =
+                options.compress ? lz4_compress(raw.data(), raw.size(), compressed.data(), raw.size() - 1) : 0;
+            if (packed > 0) {
+                block.stored_bytes = static_cast<uint32_t>(packed);
+                write_bytes(out, &block, sizeof(block));
+                write_bytes(out, compressed.data(), packed);
+            } else {
+                block.stored_bytes = static_cast<uint32_t>(raw.size()) | raw_flag;
+                write_bytes(out, &block, sizeof(block));
+                write_bytes(out, raw.data(), raw.size());
+            }
+        }
+    }
+    if (!out.flush()) {
+        throw std::runtime_error("Checkpoint write failed.");
+    }
+}
+
+CheckpointHeader read_checkpoint_header(std::istream& in) {
+    CheckpointHeader header;
+    read_bytes(in, &header, sizeof(header));
+    if (header.magic != checkpoint_magic) {
+        throw std::runtime_error("Not a ring buffer checkpoint.");
+    }
+    if (header.crc != header_crc(header) || header.capacity == 0 || header.size > header.capacity ||
+        header.element_size == 0) {
+        throw std::runtime_error("Checkpoint header is corrupt.");
+    }
+    if (header.capacity > std::numeric_limits<size_t>::max() / header.element_size) {
+        throw std::runtime_error("Checkpoint capacity does not fit in memory.");
+    }
+    const std::streamoff remaining = remaining_bytes(in);
+    if (remaining >= 0 && header.size * header.element_size > static_cast<uint64_t>(remaining) * max_expansion) {
+        throw std::runtime_error("Checkpoint is shorter than its header claims.");
+    }
+    return header;
+}
+
+void read_checkpoint_blocks(std::istream& in, std::span<std::byte> out) {
+    std::vector<std::byte> compressed;
+    while (!out.empty()) {
+        BlockHeader block;
+        read_bytes(in, &block, sizeof(block));
+        if (block.raw_bytes == 0 || block.raw_bytes > out.size()) {
+            throw std::runtime_error("Checkpoint block size is corrupt.");
+        }
+        const std::span<std::byte> target = out.first(block.raw_bytes);
+        if ((block.stored_bytes & raw_flag) != 0) {
+            if ((block.stored_bytes & ~raw_flag) != block.raw_bytes) {
+                throw std::runtime_error("Checkpoint block size is corrupt.");
+            }
+            read_bytes(in, target.data(), target.size());
+        } else {
+            if (block.stored_bytes > lz4_compress_bound(block.raw_bytes)) {
+                throw std::runtime_error("Checkpoint block size is corrupt.");
+            }
+            compressed.resize(block.stored_bytes);
+            read_bytes(in, compressed.data(), compressed.size());
+            if (lz4_decompress(compressed.data(), compressed.size(), target.data(), target.size()) != target.size()) {
+                throw std::runtime_error("Checkpoint block decompressed to the wrong size.");
+            }
+        }
+        if (crc32c(target.data(), target.size()) != block.crc) {
+            throw std::runtime_error("Checkpoint block checksum mismatch.");
+        }
+        out = out.subspan(block.raw_bytes);
+    }
+}
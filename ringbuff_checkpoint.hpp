@@ -0,0 +1,81 @@
+#ifndef RING_BUFFER_CHECKPOINT_HPP
+#define RING_BUFFER_CHECKPOINT_HPP
+
+#include <cstddef>      // For size_t, std::byte
+#include <cstdint>      // For uint32_t, uint64_t
+#include <istream>      // For std::istream
+#include <ostream>      // For std::ostream
+#include <span>         // For std::span, std::as_bytes
+#include <stdexcept>    // For std::runtime_error
+#include <type_traits>  // For std::is_trivially_copyable_v
+
+#include "ringbuff.hpp"
+
+// Settings for save_checkpoint().
+struct CheckpointOptions {
+    size_t block_bytes = 64u << 10;  // Raw bytes per block; each block is compressed on its own
+    bool compress = true;            // LZ4-compress blocks; false stores every block raw
+};
+
+// Writes the contents of a ring to a stream, oldest element first.
+// Each segment of the ring is cut into blocks that are compressed with the LZ4
+// block codec (ringbuff_lz4.hpp); a block that does not shrink is stored raw.
+// Every block carries a CRC-32C of its raw bytes.
+// Throws std::invalid_argument for unusable options and std::runtime_error if the stream fails.
+template <typename T>
+void save_checkpoint(const RingBuffer<T>& ring, std::ostream& out, const CheckpointOptions& options = {});
+
+// Reads a ring written by save_checkpoint(), with the same capacity and contents.
+// Blocks are decompressed one at a time straight into the ring's storage.
+// Throws std::runtime_error if the stream fails or the checkpoint is corrupt or of a different type.
+template <typename T>
+RingBuffer<T> load_checkpoint(std::istream& in);
+
+// Fixed header at the start of a checkpoint, in host byte order.
+struct CheckpointHeader {
+    uint32_t magic;         // checkpoint_magic
+    uint32_t element_size;  // sizeof(T) of the saved ring
+    uint64_t capacity;      // Capacity of the saved ring
+    uint64_t size;          // Elements saved
+    uint32_t crc = 0;       // CRC-32C of the fields above; set by write_checkpoint()
+    uint32_t reserved = 0;  // Zero
+};
+static_assert(sizeof(CheckpointHeader) == 32, "Checkpoint header must be 32 bytes");
+
+// Writes the header followed by the bytes of `first` and then `second` as blocks.
+void write_checkpoint(std::ostream& out, const CheckpointHeader& header, std::span<const std::byte> first,
+                      std::span<const std::byte> second, const CheckpointOptions& options);
+
+// Reads and validates a checkpoint header: its checksum, size <= capacity, a
+// ring that fits in memory and, if the stream can seek, enough bytes left to
+// hold `size` elements. Nothing is allocated until these checks pass.
+CheckpointHeader read_checkpoint_header(std::istream& in);
+
+// Reads blocks until `out` is filled, checking each block's checksum.
+void read_checkpoint_blocks(std::istream& in, std::span<std::byte> out);
+
+inline constexpr uint32_t checkpoint_magic = 0x4B434252;  // "RBCK"
+
+template <typename T>
+void save_checkpoint(const RingBuffer<T>& ring, std::ostream& out, const CheckpointOptions& options) {
+    static_assert(std::is_trivially_copyable_v<T>, "Checkpoints require a trivially copyable T");
+    const auto [first, second] = ring.segments();
+    const CheckpointHeader header{checkpoint_magic, static_cast<uint32_t>(sizeof(T)), ring.capacity(), ring.size()};
+    write_checkpoint(out, header, std::as_bytes(first), std::as_bytes(second), options);
+}
+
+template <typename T>
+RingBuffer<T> load_checkpoint(std::istream& in) {
+    static_assert(std::is_trivially_copyable_v<T>, "Checkpoints require a trivially copyable T");
+    const CheckpointHeader header = read_checkpoint_header(in);
+    if (header.element_size != sizeof(T)) {
+        throw std::runtime_error("Checkpoint element size does not match.");
+    }
+    RingBuffer<T> ring(static_cast<size_t>(header.capacity));
+    const auto [first, second] = ring.free_segments();
+    read_checkpoint_blocks(in, std::as_writable_bytes(first.first(static_cast<size_t>(header.size))));
+    ring.commit(static_cast<size_t>(header.size));
+    return ring;
+}
+
+#endif // RING_BUFFER_CHECKPOINT_HPP
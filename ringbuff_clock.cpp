@@ -0,0 +1,121 @@
+#include "ringbuff_clock.hpp"
+
+#include <time.h>
+
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace {
+
+uint64_t monotonic_ns() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000u + static_cast<uint64_t>(now.tv_nsec);
+}
+
+}  // namespace
+
+TscClock::TscClock(std::chrono::nanoseconds calibration, std::chrono::nanoseconds recalibrate_every)
+    : origin_(sample()) {
+    std::this_thread::sleep_for(calibration);
+    recalibrate();
+    if (recalibrate_every.count() > 0) {
+        refresh_ticks_ = static_cast<uint64_t>(static_cast<double>(recalibrate_every.count()) * 1e-9 *
+                                               ticks_per_second());
+        refresh_ticks_ = refresh_ticks_ > 0 ? refresh_ticks_ : 1;
+    }
+}
+
+const TscClock& TscClock::process() {
+    static const TscClock clock;
+    return clock;
+}
+
+TscClock::Sample TscClock::sample() {
+    // Bracket the clock read with counter reads and keep the tightest of a few tries,
+    // so a preemption or interrupt in between does not skew the pair.
+    Sample best{0, 0};
+    uint64_t best_width = UINT64_MAX;
+    for (int attempt = 0; attempt < 5; ++attempt) {
+        const uint64_t before = now_ordered();
+        const uint64_t ns = monotonic_ns();
+        const uint64_t after = now_ordered();
+        if (after - before < best_width) {
+            best_width = after - before;
+            best = Sample{before + (after - before) / 2, ns};
+        }
+    }
+    return best;
+}
+
+uint64_t TscClock::to_ns(uint64_t tsc) const {
+    for (;;) {
+        const uint64_t version = version_.load(std::memory_order_acquire);
+        const uint64_t base_tsc = base_tsc_.load(std::memory_order_relaxed);
+        const uint64_t base_ns = base_ns_.load(std::memory_order_relaxed);
+        const uint64_t mult = mult_.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((version & 1) == 0 && version_.load(std::memory_order_relaxed) == version) {
+            if (refresh_ticks_ != 0 && tsc >= base_tsc && tsc - base_tsc >= refresh_ticks_ &&
+                !updating_.exchange(true, std::memory_order_acquire)) {
+                // Due for a recalibration and no other thread is running one.
+                update();
+                updating_.store(false, std::memory_order_release);
+                continue;
+            }
+            // Readings taken just before the anchor convert to slightly earlier times.
+            if (tsc >= base_tsc) {
+                return base_ns + static_cast<uint64_t>((static_cast<unsigned __int128>(tsc - base_tsc) * mult) >> shift);
+            }
+            return base_ns - static_cast<uint64_t>((static_cast<unsigned __int128>(base_tsc - tsc) * mult) >> shift);
+        }
+    }
+}
+
+uint64_t TscClock::ticks_to_ns(uint64_t ticks) const {
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(ticks) * mult_.load(std::memory_order_relaxed)) >> shift);
+}
+
+double TscClock::ticks_per_second() const {
+    return 1e9 * static_cast<double>(uint64_t{1} << shift) / static_cast<double>(mult_.load(std::memory_order_relaxed));
+}
+
+void TscClock::recalibrate() {
+    while (updating_.exchange(true, std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    update();
+    updating_.store(false, std::memory_order_release);
+}
+
+void TscClock::update() const {
+    const Sample current = sample();
+    const uint64_t ticks = current.tsc - origin_.tsc;
+    const uint64_t ns = current.ns - origin_.ns;
+    const uint64_t mult =
+        ticks > 0 ? static_cast<uint64_t>((static_cast<unsigned __int128>(ns) << shift) / ticks) : uint64_t{1} << shift;
+
+    const uint64_t version = version_.load(std::memory_order_relaxed);
+    version_.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    base_tsc_.store(current.tsc, std::memory_order_relaxed);
+    base_ns_.store(current.ns, std::memory_order_relaxed);
+    mult_.store(mult, std::memory_order_relaxed);
+    version_.store(version + 2, std::memory_order_release);
+}
+
+bool TscClock::invariant() {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 || eax < 0x80000007) {
+        return false;
+    }
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    return (edx & (1u << 8)) != 0;
+#else
+    return true;
+#endif
+}
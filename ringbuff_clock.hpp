@@ -0,0 +1,103 @@
+#ifndef RING_BUFFER_CLOCK_HPP
+#define RING_BUFFER_CLOCK_HPP
+
+#include <atomic>   // For std::atomic
+#include <chrono>   // For std::chrono::nanoseconds, std::chrono::steady_clock
+#include <cstdint>  // For uint32_t, uint64_t
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>  // For __rdtsc, __rdtscp
+#endif
+
+// A cheap timestamp source for stamping ring entries.
+// Producers read the CPU time stamp counter with now(), which costs a few
+// nanoseconds instead of a clock_gettime() call. Consumers convert readings to
+// CLOCK_MONOTONIC nanoseconds with to_ns(), using a rate calibrated against
+// CLOCK_MONOTONIC at construction and refined by recalibrate(), which to_ns()
+// also runs on its own once readings are a set interval past the last anchor.
+// On targets without a usable counter, now() returns CLOCK_MONOTONIC
+// nanoseconds and the conversion is the identity.
+class TscClock {
+public:
+    // A counter reading paired with the CLOCK_MONOTONIC time it was taken at.
+    struct Sample {
+        uint64_t tsc;
+        uint64_t ns;
+    };
+
+    // Calibrates the counter against CLOCK_MONOTONIC over `calibration`,
+    // sleeping for that long. Longer calibrations give a more accurate rate.
+    // to_ns() recalibrates when it converts a reading more than
+    // `recalibrate_every` past the last anchor; zero turns that off.
+    explicit TscClock(std::chrono::nanoseconds calibration = std::chrono::milliseconds(10),
+                      std::chrono::nanoseconds recalibrate_every = std::chrono::seconds(1));
+
+    // Returns a process-wide clock, calibrated on first use and kept
+    // recalibrated by its own conversions.
+    static const TscClock& process();
+
+    // Reads the counter. Not ordered with surrounding loads and stores.
+    static uint64_t now();
+
+    // Reads the counter after every earlier instruction has completed.
+    static uint64_t now_ordered();
+
+    // Takes a counter reading and a CLOCK_MONOTONIC reading as close together as possible.
+    // Async-signal-safe.
+    static Sample sample();
+
+    // Converts a counter reading to CLOCK_MONOTONIC nanoseconds.
+    // Recalibrates first when the reading is due, unless another thread already is.
+    uint64_t to_ns(uint64_t tsc) const;
+
+    // Converts a difference between two counter readings to nanoseconds.
+    uint64_t ticks_to_ns(uint64_t ticks) const;
+
+    // Returns the calibrated counter frequency.
+    double ticks_per_second() const;
+
+    // Re-measures the rate over the whole time since construction and re-anchors
+    // the conversion at the current time, absorbing drift between the counter and
+    // CLOCK_MONOTONIC. Safe to call from any thread while others convert.
+    void recalibrate();
+
+    // Checks whether the CPU advertises a constant-rate counter that keeps
+    // running in deep sleep states (invariant TSC).
+    static bool invariant();
+
+private:
+    static constexpr unsigned shift = 32;  // Fixed-point scale of mult
+
+    // Re-anchors the conversion. The caller holds updating_.
+    void update() const;
+
+    // The conversion is a cache of the counter rate, so to_ns() may refresh it
+    // on a const clock such as process().
+    Sample origin_;                                  // Calibration starting point
+    uint64_t refresh_ticks_ = 0;                     // Anchor age that triggers update() in to_ns(); 0 = never
+    mutable std::atomic<bool> updating_{false};      // Held by the thread running update()
+    mutable std::atomic<uint64_t> version_{0};       // Odd while update() rewrites the fields below
+    mutable std::atomic<uint64_t> base_tsc_{0};      // Anchor of the conversion
+    mutable std::atomic<uint64_t> base_ns_{0};
+    mutable std::atomic<uint64_t> mult_{0};          // Nanoseconds per tick, scaled by 2^shift
+};
+
+inline uint64_t TscClock::now() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+inline uint64_t TscClock::now_ordered() {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int cpu;
+    return __rdtscp(&cpu);
+#else
+    return now();
+#endif
+}
+
+#endif // RING_BUFFER_CLOCK_HPP
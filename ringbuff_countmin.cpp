@@ -0,0 +1,104 @@
+#include "ringbuff_countmin.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// Eight counters at a time: SSE2 or AVX2 depending on the target, through GCC/Clang vector extensions.
+typedef uint32_t Lanes __attribute__((vector_size(32), aligned(4), may_alias));
+constexpr size_t lanes = sizeof(Lanes) / sizeof(uint32_t);
+
+// Subtracts expired from totals, except where a total is saturated: it may
+// stand for more than UINT32_MAX, so subtracting could undercount. Returns
+// true if any total was saturated.
+bool subtract(uint32_t* totals, const uint32_t* expired, size_t count) {
+    Lanes any_saturated{};
+    for (size_t i = 0; i < count; i += lanes) {
+        Lanes& total = *reinterpret_cast<Lanes*>(totals + i);
+        const Lanes saturated = (Lanes)(total == UINT32_MAX);
+        total -= *reinterpret_cast<const Lanes*>(expired + i) & ~saturated;
+        any_saturated |= saturated;
+    }
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        if (any_saturated[lane] != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+WindowedCountMin::WindowedCountMin(size_t width, size_t depth, size_t epochs)
+    : depth_(depth), epochs_(epochs == 0 ? 1 : epochs) {
+    if (width == 0 || depth == 0 || epochs == 0) {
+        throw std::invalid_argument("WindowedCountMin width, depth and epochs must be greater than 0.");
+    }
+    if (depth > max_depth) {
+        throw std::invalid_argument("WindowedCountMin depth is too large.");
+    }
+    width_ = lanes;
+    while (width_ < width) {
+        if (width_ > (static_cast<size_t>(-1) >> 1) / depth) {
+            throw std::invalid_argument("WindowedCountMin width is too large.");
+        }
+        width_ <<= 1;
+    }
+    mask_ = width_ - 1;
+    totals_.assign(width_ * depth_, 0);
+    epochs_.push(Epoch{std::vector<uint32_t>(width_ * depth_, 0), 0});
+    current_ = &epochs_.at(0);
+}
+
+void WindowedCountMin::tick() {
+    if (!epochs_.full()) {
+        epochs_.push(Epoch{std::vector<uint32_t>(width_ * depth_, 0), 0});
+    } else {
+        Epoch expired = epochs_.pop();
+        if (subtract(totals_.data(), expired.counters.data(), expired.counters.size())) {
+            resum_saturated();
+        }
+        std::memset(expired.counters.data(), 0, expired.counters.size() * sizeof(uint32_t));
+        total_ -= expired.total;
+        expired.total = 0;
+        epochs_.push(std::move(expired));
+    }
+    current_ = &epochs_.at(epochs_.size() - 1);
+}
+
+void WindowedCountMin::resum_saturated() {
+    // A saturated epoch counter saturates the sum, as its true count may be
+    // higher; otherwise the epochs hold exact sums and so does the result.
+    for (size_t cell = 0; cell < totals_.size(); ++cell) {
+        if (totals_[cell] != UINT32_MAX) {
+            continue;
+        }
+        uint64_t sum = 0;
+        for (size_t i = 0; i < epochs_.size(); ++i) {
+            sum += epochs_.at(i).counters[cell];
+        }
+        totals_[cell] = static_cast<uint32_t>(std::min<uint64_t>(sum, UINT32_MAX));
+    }
+}
+
+uint64_t WindowedCountMin::total() const {
+    return total_;
+}
+
+size_t WindowedCountMin::width() const {
+    return width_;
+}
+
+size_t WindowedCountMin::depth() const {
+    return depth_;
+}
+
+size_t WindowedCountMin::epochs() const {
+    return epochs_.capacity();
+}
+
+size_t WindowedCountMin::memory_bytes() const {
+    return (epochs_.capacity() + 1) * width_ * depth_ * sizeof(uint32_t);
+}
@@ -0,0 +1,120 @@
+#ifndef RING_BUFFER_COUNTMIN_HPP
+#define RING_BUFFER_COUNTMIN_HPP
+
+#include <algorithm>  // For std::min
+#include <cstddef>    // For size_t
+#include <cstdint>    // For uint32_t, uint64_t
+#include <vector>     // For std::vector
+
+#include "ringbuff.hpp"
+
+// Approximate per-key counts over a sliding window, for heavy hitters and
+// abuse detection across millions of keys in bounded memory.
+// The window is a RingBuffer of count-min sketch epochs plus a running total
+// sketch. add() increments one counter per row in the current epoch and in
+// the total; estimate() reads the total. tick() starts a new epoch, and once
+// `epochs` epochs are in the window, it subtracts the expiring epoch from the
+// total and reuses its zeroed storage for the new one.
+// Estimates never undercount. With width w, each row overcounts by more than
+// e/w of the window total with probability at most 1/e, so depth d rows
+// bring that down to e^-d.
+// Counters are 32 bits and saturate at UINT32_MAX instead of wrapping, so a
+// count that large still never reads low. A saturated total is recomputed
+// from the epochs left in the window when an epoch expires.
+// Keys are 64-bit values such as ids or string hashes; they are remixed
+// internally, so sequential ids are fine. Not thread-safe.
+class WindowedCountMin {
+public:
+    // Constructs an empty window of `epochs` epochs of `depth` rows of
+    // `width` counters. width is rounded up to a power of two of at least 8.
+    // Throws std::invalid_argument if any argument is 0 or depth is over 16.
+    WindowedCountMin(size_t width, size_t depth, size_t epochs);
+
+    // Adds `count` occurrences of key to the current epoch. Counters stop at UINT32_MAX.
+    void add(uint64_t key, uint32_t count = 1);
+
+    // Returns an estimate of the occurrences of key in the window, never below
+    // the true count. Returns UINT32_MAX if a count has reached it.
+    uint32_t estimate(uint64_t key) const;
+
+    // Starts a new epoch. Once the window holds `epochs` epochs, the oldest expires.
+    // Costs O(width * depth), vectorized.
+    void tick();
+
+    // Returns the exact number of occurrences added within the window.
+    uint64_t total() const;
+
+    // Returns the number of counters per row, after rounding.
+    size_t width() const;
+
+    // Returns the number of rows.
+    size_t depth() const;
+
+    // Returns the number of epochs the window spans, including the current one.
+    size_t epochs() const;
+
+    // Returns the bytes held by the counters.
+    size_t memory_bytes() const;
+
+    static constexpr size_t max_depth = 16;
+
+private:
+    struct Epoch {
+        std::vector<uint32_t> counters;  // depth rows of width counters
+        uint64_t total = 0;              // Occurrences added during the epoch
+    };
+
+    static uint64_t mix(uint64_t key);
+    static uint32_t saturating_add(uint32_t counter, uint32_t count);
+    void resum_saturated();
+
+    size_t width_;
+    size_t mask_;                         // width_ - 1
+    size_t depth_;
+    RingBuffer<Epoch> epochs_;            // Oldest first; the last one is current
+    Epoch* current_;                      // The newest epoch in epochs_
+    std::vector<uint32_t> totals_;        // Sum of every epoch in epochs_
+    uint64_t total_ = 0;
+};
+
+inline uint64_t WindowedCountMin::mix(uint64_t key) {
+    // splitmix64 finalizer.
+    key += 0x9E3779B97F4A7C15ull;
+    key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ull;
+    key = (key ^ (key >> 27)) * 0x94D049BB133111EBull;
+    return key ^ (key >> 31);
+}
+
+inline uint32_t WindowedCountMin::saturating_add(uint32_t counter, uint32_t count) {
+    const uint32_t sum = counter + count;
+    return sum < count ? UINT32_MAX : sum;
+}
+
+inline void WindowedCountMin::add(uint64_t key, uint32_t count) {
+    // Row indices come from h1 + i * h2 (Kirsch-Mitzenmacher), one hash per key.
+    const uint64_t hash = mix(key);
+    const size_t h1 = static_cast<size_t>(hash);
+    const size_t h2 = static_cast<size_t>(hash >> 32) | 1;
+    uint32_t* epoch = current_->counters.data();
+    uint32_t* totals = totals_.data();
+    for (size_t row = 0; row < depth_; ++row) {
+        const size_t cell = row * width_ + ((h1 + row * h2) & mask_);
+        epoch[cell] = saturating_add(epoch[cell], count);
+        totals[cell] = saturating_add(totals[cell], count);
+    }
+    current_->total += count;
+    total_ += count;
+}
+
+inline uint32_t WindowedCountMin::estimate(uint64_t key) const {
+    const uint64_t hash = mix(key);
+    const size_t h1 = static_cast<size_t>(hash);
+    const size_t h2 = static_cast<size_t>(hash >> 32) | 1;
+    uint32_t result = UINT32_MAX;
+    for (size_t row = 0; row < depth_; ++row) {
+        result = std::min(result, totals_[row * width_ + ((h1 + row * h2) & mask_)]);
+    }
+    return result;
+}
+
+#endif // RING_BUFFER_COUNTMIN_HPP
@@ -0,0 +1,122 @@
+#include "ringbuff_crc32c.hpp"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define RING_BUFFER_CRC32C_SSE42 1
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define RING_BUFFER_CRC32C_ARM 1
+#endif
+
+namespace {
+
+constexpr uint32_t castagnoli = 0x82F63B78;  // Reflected CRC-32C polynomial
+
+// Slicing-by-8 tables: tables[k][b] is the CRC of byte b followed by k zero bytes.
+constexpr std::array<std::array<uint32_t, 256>, 8> make_tables() {
+    std::array<std::array<uint32_t, 256>, 8> tables{};
+    for (uint32_t b = 0; b < 256; ++b) {
+        uint32_t crc = b;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (castagnoli & (0u - (crc & 1)));
+        }
+        tables[0][b] = crc;
+    }
+    for (uint32_t b = 0; b < 256; ++b) {
+        for (size_t k = 1; k < 8; ++k) {
+            tables[k][b] = (tables[k - 1][b] >> 8) ^ tables[0][tables[k - 1][b] & 0xFF];
+        }
+    }
+    return tables;
+}
+
+constexpr auto tables = make_tables();
+
+uint32_t crc32c_software(const unsigned char* p, size_t size, uint32_t crc) {
+    while (size >= 8) {
+        uint32_t low;
+        uint32_t high;
+        std::memcpy(&low, p, 4);
+        std::memcpy(&high, p + 4, 4);
+        low ^= crc;
+        crc = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF] ^
+              tables[5][(low >> 16) & 0xFF] ^ tables[4][low >> 24] ^
+              tables[3][high & 0xFF] ^ tables[2][(high >> 8) & 0xFF] ^
+              tables[1][(high >> 16) & 0xFF] ^ tables[0][high >> 24];
+        p += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = (crc >> 8) ^ tables[0][(crc ^ *p++) & 0xFF];
+    }
+    return crc;
+}
+
+#if defined(RING_BUFFER_CRC32C_SSE42)
+// SSE4.2 crc32 retires 8 bytes per instruction. Compiled for that target only,
+// and selected at run time so the library still runs on older CPUs.
+__attribute__((target("sse4.2"))) uint32_t crc32c_hardware(const unsigned char* p, size_t size, uint32_t crc) {
+    uint64_t crc64 = crc;
+    while (size >= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        crc64 = _mm_crc32_u64(crc64, word);
+        p += 8;
+        size -= 8;
+    }
+    crc = static_cast<uint32_t>(crc64);
+    while (size-- > 0) {
+        crc = _mm_crc32_u8(crc, *p++);
+    }
+    return crc;
+}
+
+bool hardware_available() {
+    return __builtin_cpu_supports("sse4.2");
+}
+#elif defined(RING_BUFFER_CRC32C_ARM)
+uint32_t crc32c_hardware(const unsigned char* p, size_t size, uint32_t crc) {
+    while (size >= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        crc = __crc32cd(crc, word);
+        p += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = __crc32cb(crc, *p++);
+    }
+    return crc;
+}
+
+bool hardware_available() {
+    return true;
+}
+#else
+uint32_t crc32c_hardware(const unsigned char* p, size_t size, uint32_t crc) {
+    return crc32c_software(p, size, crc);
+}
+
+bool hardware_available() {
+    return false;
+}
+#endif
+
+}  // namespace
+
+uint32_t crc32c(const void* data, size_t size, uint32_t crc) {
+    // Selected on first use, so checksums taken during static initialization work too.
+    static const auto selected = hardware_available() ? crc32c_hardware : crc32c_software;
+    return ~selected(static_cast<const unsigned char*>(data), size, ~crc);
+}
+
+uint32_t crc32c_portable(const void* data, size_t size, uint32_t crc) {
+    return ~crc32c_software(static_cast<const unsigned char*>(data), size, ~crc);
+}
+
+bool crc32c_hardware_accelerated() {
+    return hardware_available();
+}
@@ -0,0 +1,20 @@
+#ifndef RING_BUFFER_CRC32C_HPP
+#define RING_BUFFER_CRC32C_HPP
+
+#include <cstddef>  // For size_t
+#include <cstdint>  // For uint32_t
+
+// CRC-32C (Castagnoli) checksums for records persisted or shared from rings.
+
+// Computes the CRC-32C of `size` bytes at `data`.
+// Pass a previous result as `crc` to continue a checksum across buffers.
+// Uses the SSE4.2 or ARMv8 CRC instructions when the CPU has them.
+uint32_t crc32c(const void* data, size_t size, uint32_t crc = 0);
+
+// Same as crc32c(), always using the table-driven software implementation.
+uint32_t crc32c_portable(const void* data, size_t size, uint32_t crc = 0);
+
+// Checks whether crc32c() runs on dedicated CRC instructions on this CPU.
+bool crc32c_hardware_accelerated();
+
+#endif // RING_BUFFER_CRC32C_HPP
@@ -0,0 +1,161 @@
+#include "ringbuff_epoch.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Domains that are still alive, so exiting threads only release records in those.
+std::mutex& registry_mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::unordered_set<uint64_t>& live_domains() {
+    static std::unordered_set<uint64_t> domains;
+    return domains;
+}
+
+std::atomic<uint64_t> next_domain_id{1};
+
+// Records claimed by this thread, released when the thread exits.
+struct ThreadRecords {
+    std::vector<std::pair<uint64_t, std::atomic<bool>*>> owned;  // (domain id, record's owned flag)
+    std::vector<void*> records;                                   // Matching record addresses
+
+    ~ThreadRecords() {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        for (const auto& [domain_id, flag] : owned) {
+            if (live_domains().count(domain_id) != 0) {
+                flag->store(false, ring_order::release);
+            }
+        }
+    }
+
+    void* find(uint64_t domain_id) const {
+        for (size_t i = 0; i < owned.size(); ++i) {
+            if (owned[i].first == domain_id) {
+                return records[i];
+            }
+        }
+        return nullptr;
+    }
+
+    // Drops entries for domains that no longer exist. Caller holds the registry lock.
+    void prune() {
+        size_t kept = 0;
+        for (size_t i = 0; i < owned.size(); ++i) {
+            if (live_domains().count(owned[i].first) != 0) {
+                owned[kept] = owned[i];
+                records[kept] = records[i];
+                ++kept;
+            }
+        }
+        owned.resize(kept);
+        records.resize(kept);
+    }
+};
+
+thread_local ThreadRecords thread_records;
+
+}  // namespace
+
+EpochDomain::EpochDomain(size_t max_threads)
+    : id_(next_domain_id.fetch_add(1, ring_order::relaxed)), max_threads_(max_threads) {
+    if (max_threads == 0) {
+        throw std::invalid_argument("EpochDomain must support at least one thread.");
+    }
+    records_.reset(new Record[max_threads_]);
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    live_domains().insert(id_);
+}
+
+EpochDomain::~EpochDomain() {
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        live_domains().erase(id_);
+    }
+    for (size_t i = 0; i < max_threads_; ++i) {
+        for (auto& entry : records_[i].limbo) {
+            entry.second();
+        }
+    }
+}
+
+EpochDomain::Record& EpochDomain::claim_record() {
+    // The thread may already own a record here and have used another domain since.
+    if (void* known = thread_records.find(id_)) {
+        last_record_ = {id_, static_cast<Record*>(known)};
+        return *last_record_.record;
+    }
+
+    for (size_t i = 0; i < max_threads_; ++i) {
+        bool expected = false;
+        if (records_[i].owned.load(ring_order::relaxed) ||
+            !records_[i].owned.compare_exchange_strong(expected, true, ring_order::acquire)) {
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex());
+            thread_records.prune();
+            thread_records.owned.emplace_back(id_, &records_[i].owned);
+            thread_records.records.push_back(&records_[i]);
+        }
+        last_record_ = {id_, &records_[i]};
+        return records_[i];
+    }
+    throw std::runtime_error("EpochDomain has no free thread record.");
+}
+
+void EpochDomain::retire(std::function<void()> reclaim) {
+    Record& record = local_record();
+    size_t pending;
+    {
+        std::lock_guard<std::mutex> lock(record.limbo_mutex);
+        record.limbo.emplace_back(global_epoch_.load(ring_order::acquire), std::move(reclaim));
+        pending = record.limbo.size();
+    }
+    if (pending >= retire_threshold) {
+        collect();
+    }
+}
+
+bool EpochDomain::try_advance() {
+    uint64_t epoch = global_epoch_.load(ring_order::acquire);
+    std::atomic_thread_fence(ring_order::seq_cst);
+    for (size_t i = 0; i < max_threads_; ++i) {
+        const uint64_t state = records_[i].state.load(ring_order::acquire);
+        if ((state & 1) != 0 && (state >> 1) != epoch) {
+            return false;
+        }
+    }
+    return global_epoch_.compare_exchange_strong(epoch, epoch + 1, ring_order::acq_rel);
+}
+
+void EpochDomain::collect() {
+    // Two advances make everything retired before this call reclaimable when
+    // no thread is pinned; a pinned straggler stops the loop early.
+    for (int i = 0; i < 2 && try_advance(); ++i) {
+    }
+    const uint64_t epoch = global_epoch_.load(ring_order::acquire);
+
+    std::vector<std::function<void()>> ready;
+    for (size_t i = 0; i < max_threads_; ++i) {
+        Record& record = records_[i];
+        std::lock_guard<std::mutex> lock(record.limbo_mutex);
+        auto safe = std::stable_partition(record.limbo.begin(), record.limbo.end(),
+                                          [epoch](const auto& entry) { return entry.first + 2 > epoch; });
+        for (auto it = safe; it != record.limbo.end(); ++it) {
+            ready.push_back(std::move(it->second));
+        }
+        record.limbo.erase(safe, record.limbo.end());
+    }
+    // Callbacks run without any record lock so that they may take their own locks.
+    for (auto& reclaim : ready) {
+        reclaim();
+    }
+}
@@ -0,0 +1,132 @@
+#ifndef RING_BUFFER_EPOCH_HPP
+#define RING_BUFFER_EPOCH_HPP
+
+#include <atomic>      // For std::atomic, std::atomic_thread_fence
+#include <cstddef>     // For size_t
+#include <cstdint>     // For uint64_t
+#include <functional>  // For std::function
+#include <memory>      // For std::unique_ptr
+#include <mutex>       // For std::mutex
+#include <utility>     // For std::pair
+#include <vector>      // For std::vector
+
+#include "ringbuff_memory_order.hpp"
+
+// Epoch-based reclamation (EBR) for concurrent rings that unlink storage
+// while other threads may still be reading it.
+// Readers bracket every access with pin(), which only stores the current
+// global epoch into the thread's own record and issues a fence: no shared data
+// is read-modify-written and no shared cache line is written on the read path.
+// Writers hand unlinked storage to retire(); it is reclaimed once every pinned
+// thread has been observed in a later epoch, which takes two epoch advances.
+class EpochDomain {
+private:
+    struct Record;
+
+public:
+    // Constructs a domain that supports up to max_threads threads pinned or
+    // retiring concurrently. Throws std::invalid_argument if max_threads is 0.
+    explicit EpochDomain(size_t max_threads = 256);
+
+    // Runs every pending reclaim. No thread may be pinned at this point.
+    ~EpochDomain();
+
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    // A read-side critical section. Pointers loaded while a guard is alive
+    // stay valid until the guard is destroyed. Guards may nest.
+    class Guard {
+    public:
+        Guard(Guard&& other) noexcept;
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        Guard& operator=(Guard&&) = delete;
+        ~Guard();
+
+    private:
+        friend class EpochDomain;
+        explicit Guard(Record* record);
+
+        Record* record_;  // The calling thread's record, nullptr once moved from
+    };
+
+    // Enters a read-side critical section for the calling thread.
+    // Throws std::runtime_error if more than max_threads threads use the domain.
+    Guard pin();
+
+    // Defers `reclaim` until no thread can still hold a pointer unlinked
+    // before this call. The callback runs on whichever thread collects it.
+    void retire(std::function<void()> reclaim);
+
+    // Attempts to advance the global epoch and runs every reclaim that has
+    // become safe, regardless of which thread retired it.
+    void collect();
+
+    // Returns the current global epoch.
+    uint64_t epoch() const;
+
+private:
+    struct alignas(64) Record {
+        std::atomic<uint64_t> state{0};  // (epoch << 1) | 1 while pinned, 0 otherwise
+        std::atomic<bool> owned{false};  // Whether a live thread has claimed this record
+        unsigned depth = 0;              // Guard nesting depth, owner thread only
+        std::mutex limbo_mutex;          // Guards limbo against collectors on other threads
+        std::vector<std::pair<uint64_t, std::function<void()>>> limbo;  // (retire epoch, reclaim)
+    };
+
+    // Fast path cache of the calling thread's record in the most recently used domain.
+    struct LastRecord {
+        uint64_t domain_id;
+        Record* record;
+    };
+
+    static constexpr size_t retire_threshold = 8;  // Limbo size that triggers a collection
+
+    Record& local_record();
+    Record& claim_record();
+    bool try_advance();
+
+    static inline thread_local LastRecord last_record_{};
+
+    uint64_t id_;                             // Unique for the lifetime of the process
+    size_t max_threads_;                      // Number of records
+    std::unique_ptr<Record[]> records_;       // One record per participating thread
+    alignas(64) std::atomic<uint64_t> global_epoch_{1};
+};
+
+inline EpochDomain::Guard::Guard(Record* record) : record_(record) {}
+
+inline EpochDomain::Guard::Guard(Guard&& other) noexcept : record_(other.record_) {
+    other.record_ = nullptr;
+}
+
+inline EpochDomain::Guard::~Guard() {
+    if (record_ != nullptr && --record_->depth == 0) {
+        record_->state.store(0, ring_order::release);
+    }
+}
+
+inline EpochDomain::Record& EpochDomain::local_record() {
+    if (last_record_.domain_id == id_) {
+        return *last_record_.record;
+    }
+    return claim_record();
+}
+
+inline EpochDomain::Guard EpochDomain::pin() {
+    Record& record = local_record();
+    if (record.depth++ == 0) {
+        const uint64_t epoch = global_epoch_.load(ring_order::acquire);
+        record.state.store((epoch << 1) | 1, ring_order::relaxed);
+        // Publishes the announcement before any shared pointer is loaded.
+        std::atomic_thread_fence(ring_order::seq_cst);
+    }
+    return Guard(&record);
+}
+
+inline uint64_t EpochDomain::epoch() const {
+    return global_epoch_.load(ring_order::acquire);
+}
+
+#endif // RING_BUFFER_EPOCH_HPP
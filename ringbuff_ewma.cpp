@@ -0,0 +1,197 @@
+#include "ringbuff_ewma.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// Four doubles at a time: SSE2 or AVX depending on the target, through GCC/Clang vector extensions.
+typedef double Lanes __attribute__((vector_size(32), aligned(8), may_alias));
+constexpr size_t lanes = sizeof(Lanes) / sizeof(double);
+
+Lanes& lanes_at(double* p) {
+    return *reinterpret_cast<Lanes*>(p);
+}
+
+const Lanes& lanes_at(const double* p) {
+    return *reinterpret_cast<const Lanes*>(p);
+}
+
+// Applies every sample to `count` averages (a multiple of lanes). Groups of
+// vectors of averages stay in registers across the whole batch, so their
+// update chains overlap. Inlined into each target below.
+template <size_t Groups>
+__attribute__((always_inline)) inline void blend_samples_body(double* values, const double* alphas, size_t count,
+                                                              const double* samples, size_t n) {
+    size_t i = 0;
+    for (; i + Groups * lanes <= count; i += Groups * lanes) {
+        Lanes v[Groups];
+        Lanes a[Groups];
+        for (size_t g = 0; g < Groups; ++g) {
+            v[g] = lanes_at(values + i + g * lanes);
+            a[g] = lanes_at(alphas + i + g * lanes);
+        }
+        for (size_t s = 0; s < n; ++s) {
+            const double x = samples[s];
+            for (size_t g = 0; g < Groups; ++g) {
+                v[g] += a[g] * (x - v[g]);
+            }
+        }
+        for (size_t g = 0; g < Groups; ++g) {
+            lanes_at(values + i + g * lanes) = v[g];
+        }
+    }
+    for (; i < count; i += lanes) {
+        Lanes v = lanes_at(values + i);
+        const Lanes a = lanes_at(alphas + i);
+        for (size_t s = 0; s < n; ++s) {
+            v += a * (samples[s] - v);
+        }
+        lanes_at(values + i) = v;
+    }
+}
+
+// Each update waits on the previous one for the same averages, so more groups
+// in flight beat the few register spills they cost.
+void blend_samples_portable(double* values, const double* alphas, size_t count, const double* samples, size_t n) {
+    blend_samples_body<4>(values, alphas, count, samples, n);
+}
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+// A Lanes value fills one AVX register instead of two SSE ones, so twice as
+// many groups stay in registers.
+__attribute__((target("avx2,fma"))) void blend_samples_avx2(double* values, const double* alphas, size_t count,
+                                                            const double* samples, size_t n) {
+    blend_samples_body<8>(values, alphas, count, samples, n);
+}
+#endif
+
+using BlendSamples = void (*)(double*, const double*, size_t, const double*, size_t);
+
+BlendSamples blend_samples() {
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    static const BlendSamples selected =
+        __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") ? blend_samples_avx2 : blend_samples_portable;
+#else
+    static const BlendSamples selected = blend_samples_portable;
+#endif
+    return selected;
+}
+
+// Applies inputs[i] to average i.
+void blend_each(double* values, const double* alphas, const double* inputs, size_t count) {
+    for (size_t i = 0; i < count; i += lanes) {
+        Lanes& v = lanes_at(values + i);
+        v += lanes_at(alphas + i) * (lanes_at(inputs + i) - v);
+    }
+}
+
+}  // namespace
+
+EwmaBank::EwmaBank(std::span<const double> alphas) : size_(alphas.size()) {
+    if (alphas.empty()) {
+        throw std::invalid_argument("EwmaBank needs at least one alpha.");
+    }
+    const size_t padded = (alphas.size() + lanes - 1) / lanes * lanes;
+    alphas_.assign(padded, 0.0);
+    log_keep_.assign(padded, 0.0);
+    for (size_t i = 0; i < alphas.size(); ++i) {
+        if (!(alphas[i] > 0.0 && alphas[i] <= 1.0)) {
+            throw std::invalid_argument("EwmaBank alphas must be in (0, 1].");
+        }
+        alphas_[i] = alphas[i];
+        log_keep_[i] = std::log1p(-alphas[i]);
+    }
+    timed_.assign(padded, 0.0);
+    inputs_.assign(padded, 0.0);
+    values_.assign(padded, 0.0);
+}
+
+void EwmaBank::update(std::span<const double> samples) {
+    if (samples.empty()) {
+        return;
+    }
+    if (!primed_) {
+        prime(samples.front());
+        samples = samples.subspan(1);
+    }
+    blend_samples()(values_.data(), alphas_.data(), values_.size(), samples.data(), samples.size());
+}
+
+void EwmaBank::update(std::span<const double> samples, std::span<const double> timestamps) {
+    if (samples.size() != timestamps.size()) {
+        throw std::invalid_argument("EwmaBank::update needs one timestamp per sample.");
+    }
+    size_t s = 0;
+    if (!primed_ && !samples.empty()) {
+        prime(samples.front());
+        last_time_ = timestamps.front();
+        s = 1;
+    }
+    while (s < samples.size()) {
+        // A run of samples at the same interval shares one set of alphas, and
+        // goes to the kernel as one batch.
+        const double dt = std::max(0.0, timestamps[s] - last_time_);
+        size_t end = s + 1;
+        while (end < samples.size() && std::max(0.0, timestamps[end] - timestamps[end - 1]) == dt) {
+            ++end;
+        }
+        last_time_ = timestamps[end - 1];
+        if (dt != timed_dt_) {
+            set_decay(dt);
+        }
+        blend_samples()(values_.data(), timed_.data(), values_.size(), &samples[s], end - s);
+        s = end;
+    }
+}
+
+void EwmaBank::update_each(std::span<const double> values) {
+    if (values.size() != size_) {
+        throw std::invalid_argument("EwmaBank::update_each needs one value per average.");
+    }
+    if (!primed_) {
+        std::copy(values.begin(), values.end(), values_.begin());
+        primed_ = true;
+        return;
+    }
+    // Padded copy, so the last vector does not read past the caller's values.
+    std::copy(values.begin(), values.end(), inputs_.begin());
+    blend_each(values_.data(), alphas_.data(), inputs_.data(), values_.size());
+}
+
+double EwmaBank::value(size_t i) const {
+    if (i >= size_) {
+        throw std::out_of_range("Index out of bounds for EwmaBank::value()");
+    }
+    return values_[i];
+}
+
+std::span<const double> EwmaBank::values() const {
+    return std::span<const double>(values_.data(), size_);
+}
+
+size_t EwmaBank::size() const {
+    return size_;
+}
+
+void EwmaBank::reset() {
+    std::fill(values_.begin(), values_.end(), 0.0);
+    primed_ = false;
+    timed_dt_ = -1;
+    last_time_ = 0;
+}
+
+void EwmaBank::prime(double sample) {
+    std::fill(values_.begin(), values_.begin() + static_cast<std::ptrdiff_t>(size_), sample);
+    primed_ = true;
+}
+
+void EwmaBank::set_decay(double dt) {
+    // Regularly spaced samples reuse the previous interval's alphas.
+    for (size_t i = 0; i < size_; ++i) {
+        // 1 - (1 - alpha)^dt, kept exact for alpha = 1 and dt = 0.
+        timed_[i] = dt == 0 ? 0.0 : -std::expm1(dt * log_keep_[i]);
+    }
+    timed_dt_ = dt;
+}
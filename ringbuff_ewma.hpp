@@ -0,0 +1,63 @@
+#ifndef RING_BUFFER_EWMA_HPP
+#define RING_BUFFER_EWMA_HPP
+
+#include <cstddef>  // For size_t
+#include <span>     // For std::span
+#include <vector>   // For std::vector
+
+// A bank of exponentially weighted moving averages, v <- v + alpha * (x - v),
+// each with its own alpha, updated together from batches such as those
+// returned by RingBuffer::pop_bulk(). Averages are stored side by side and
+// updated four doubles per vector, with AVX2 and FMA when the CPU has them;
+// while a batch is applied, groups of averages stay in registers across all
+// of its samples. The first sample sets every average to its value.
+class EwmaBank {
+public:
+    // Constructs one average per alpha.
+    // Throws std::invalid_argument if alphas is empty or an alpha is not in (0, 1].
+    explicit EwmaBank(std::span<const double> alphas);
+
+    // Feeds every sample, oldest first, into every average.
+    void update(std::span<const double> samples);
+
+    // Time-aware version for irregular sampling. Each alpha is the weight of
+    // one time unit: a sample taken dt units after the previous one weighs
+    // 1 - (1 - alpha)^dt, so a sample after a long gap counts more and one at
+    // the same timestamp counts nothing. Timestamps must not decrease. Runs of
+    // samples at equal intervals are applied as one batch; each change of
+    // interval costs a pass over the averages to recompute their alphas.
+    // Throws std::invalid_argument if the spans differ in size.
+    void update(std::span<const double> samples, std::span<const double> timestamps);
+
+    // Feeds values[i] into average i, for banks tracking one series per average.
+    // Throws std::invalid_argument if values.size() != size().
+    void update_each(std::span<const double> values);
+
+    // Returns average i. Throws std::out_of_range if i >= size().
+    double value(size_t i) const;
+
+    // Returns every average.
+    std::span<const double> values() const;
+
+    // Returns the number of averages.
+    size_t size() const;
+
+    // Forgets every sample; the next one sets the averages again.
+    void reset();
+
+private:
+    void prime(double sample);
+    void set_decay(double dt);
+
+    size_t size_;
+    std::vector<double> alphas_;      // Padded to whole vectors with alpha 0
+    std::vector<double> log_keep_;    // log(1 - alpha) per average, for time-aware updates
+    std::vector<double> timed_;       // Effective alphas for timed_dt_
+    std::vector<double> inputs_;      // Padded copy of the values given to update_each()
+    std::vector<double> values_;      // Padded like alphas_
+    double timed_dt_ = -1;            // Interval timed_ was computed for, -1 if none
+    double last_time_ = 0;
+    bool primed_ = false;
+};
+
+#endif // RING_BUFFER_EWMA_HPP
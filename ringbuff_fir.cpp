@@ -0,0 +1,251 @@
+#include "ringbuff_fir.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define RING_BUFFER_FIR_X86 1
+#endif
+
+namespace {
+
+float dot_portable(const float* a, const float* b, size_t count) {
+    // Four independent sums keep the adds pipelined.
+    float sums[4] = {0, 0, 0, 0};
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        sums[0] += a[i] * b[i];
+        sums[1] += a[i + 1] * b[i + 1];
+        sums[2] += a[i + 2] * b[i + 2];
+        sums[3] += a[i + 3] * b[i + 3];
+    }
+    for (; i < count; ++i) {
+        sums[0] += a[i] * b[i];
+    }
+    return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+}
+
+// out[j] = dot(taps, x + j) for j < count.
+void block_portable(const float* taps, size_t tap_count, const float* x, float* out, size_t count) {
+    for (size_t j = 0; j < count; ++j) {
+        out[j] = dot_portable(taps, x + j, tap_count);
+    }
+}
+
+#if defined(RING_BUFFER_FIR_X86)
+// Two accumulators, so consecutive FMAs do not wait on each other.
+__attribute__((target("avx2,fma"))) float dot_avx2(const float* a, const float* b, size_t count) {
+    __m256 sum0 = _mm256_setzero_ps();
+    __m256 sum1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+        sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), sum1);
+    }
+    for (; i + 8 <= count; i += 8) {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+    }
+    const __m256 sum = _mm256_add_ps(sum0, sum1);
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+    half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+    half = _mm_add_ss(half, _mm_movehdup_ps(half));
+    float result = _mm_cvtss_f32(half);
+    for (; i < count; ++i) {
+        result += a[i] * b[i];
+    }
+    return result;
+}
+
+// Vectorized across outputs instead of taps: each tap is broadcast and
+// multiplied into 8 consecutive outputs, so no horizontal sum is needed.
+// Four groups of outputs run as independent FMA chains.
+__attribute__((target("avx2,fma"))) void block_avx2(const float* taps, size_t tap_count, const float* x, float* out,
+                                                    size_t count) {
+    size_t j = 0;
+    for (; j + 32 <= count; j += 32) {
+        __m256 acc0 = _mm256_setzero_ps();
+        __m256 acc1 = _mm256_setzero_ps();
+        __m256 acc2 = _mm256_setzero_ps();
+        __m256 acc3 = _mm256_setzero_ps();
+        for (size_t k = 0; k < tap_count; ++k) {
+            const __m256 tap = _mm256_broadcast_ss(taps + k);
+            const float* in = x + j + k;
+            acc0 = _mm256_fmadd_ps(tap, _mm256_loadu_ps(in), acc0);
+            acc1 = _mm256_fmadd_ps(tap, _mm256_loadu_ps(in + 8), acc1);
+            acc2 = _mm256_fmadd_ps(tap, _mm256_loadu_ps(in + 16), acc2);
+            acc3 = _mm256_fmadd_ps(tap, _mm256_loadu_ps(in + 24), acc3);
+        }
+        _mm256_storeu_ps(out + j, acc0);
+        _mm256_storeu_ps(out + j + 8, acc1);
+        _mm256_storeu_ps(out + j + 16, acc2);
+        _mm256_storeu_ps(out + j + 24, acc3);
+    }
+    for (; j < count; ++j) {
+        out[j] = dot_avx2(taps, x + j, tap_count);
+    }
+}
+
+// GCC 12's AVX-512 headers trip -Wuninitialized on their own placeholder operands.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#endif
+__attribute__((target("avx512f"))) float dot_avx512(const float* a, const float* b, size_t count) {
+    __m512 sum0 = _mm512_setzero_ps();
+    __m512 sum1 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), sum0);
+        sum1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), sum1);
+    }
+    if (i + 16 <= count) {
+        sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), sum0);
+        i += 16;
+    }
+    if (i < count) {
+        // Masked loads read only the remaining lanes.
+        const __mmask16 mask = static_cast<__mmask16>((1u << (count - i)) - 1);
+        sum1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i), sum1);
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(sum0, sum1));
+}
+
+// Same scheme as block_avx2, 16 outputs per vector.
+__attribute__((target("avx512f"))) void block_avx512(const float* taps, size_t tap_count, const float* x, float* out,
+                                                     size_t count) {
+    size_t j = 0;
+    for (; j + 64 <= count; j += 64) {
+        __m512 acc0 = _mm512_setzero_ps();
+        __m512 acc1 = _mm512_setzero_ps();
+        __m512 acc2 = _mm512_setzero_ps();
+        __m512 acc3 = _mm512_setzero_ps();
+        for (size_t k = 0; k < tap_count; ++k) {
+            const __m512 tap = _mm512_set1_ps(taps[k]);
+            const float* in = x + j + k;
+            acc0 = _mm512_fmadd_ps(tap, _mm512_loadu_ps(in), acc0);
+            acc1 = _mm512_fmadd_ps(tap, _mm512_loadu_ps(in + 16), acc1);
+            acc2 = _mm512_fmadd_ps(tap, _mm512_loadu_ps(in + 32), acc2);
+            acc3 = _mm512_fmadd_ps(tap, _mm512_loadu_ps(in + 48), acc3);
+        }
+        _mm512_storeu_ps(out + j, acc0);
+        _mm512_storeu_ps(out + j + 16, acc1);
+        _mm512_storeu_ps(out + j + 32, acc2);
+        _mm512_storeu_ps(out + j + 48, acc3);
+    }
+    for (; j < count; ++j) {
+        out[j] = dot_avx512(taps, x + j, tap_count);
+    }
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+struct Kernel {
+    float (*dot)(const float*, const float*, size_t);
+    void (*block)(const float*, size_t, const float*, float*, size_t);
+    const char* name;
+};
+
+std::vector<Kernel> detect_kernels() {
+    std::vector<Kernel> found;
+#if defined(RING_BUFFER_FIR_X86)
+    if (__builtin_cpu_supports("avx512f")) {
+        found.push_back({dot_avx512, block_avx512, "avx512f"});
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        found.push_back({dot_avx2, block_avx2, "avx2+fma"});
+    }
+#endif
+    found.push_back({dot_portable, block_portable, "portable"});
+    return found;
+}
+
+// Every kernel this CPU can run, best first.
+const std::vector<Kernel>& kernels() {
+    // Each filter copies its kernel's pointers, so push() pays no lookup.
+    static const std::vector<Kernel> found = detect_kernels();
+    return found;
+}
+
+const Kernel& find_kernel(std::string_view instruction_set) {
+    if (instruction_set.empty()) {
+        return kernels().front();
+    }
+    for (const Kernel& kernel : kernels()) {
+        if (instruction_set == kernel.name) {
+            return kernel;
+        }
+    }
+    throw std::invalid_argument("FirFilterRing: instruction set " + std::string(instruction_set) +
+                                " is not supported on this CPU.");
+}
+
+}  // namespace
+
+FirFilterRing::FirFilterRing(std::span<const float> taps, std::string_view instruction_set)
+    : reversed_taps_(taps.rbegin(), taps.rend()), mirror_(2 * taps.size(), 0.0f) {
+    if (taps.empty()) {
+        throw std::invalid_argument("FirFilterRing needs at least one tap.");
+    }
+    const Kernel& kernel = find_kernel(instruction_set);
+    dot_ = kernel.dot;
+    block_ = kernel.block;
+    instruction_set_ = kernel.name;
+}
+
+float FirFilterRing::push(float sample) {
+    store(sample);
+    return dot_(reversed_taps_.data(), mirror_.data() + pos_, reversed_taps_.size());
+}
+
+void FirFilterRing::process(std::span<const float> in, std::span<float> out) {
+    if (out.size() != in.size()) {
+        throw std::invalid_argument("FirFilterRing::process needs an output block the size of the input block.");
+    }
+    const size_t taps = reversed_taps_.size();
+    // [ last taps - 1 samples | input block ]: output j is the dot product at offset j.
+    scratch_.resize(taps - 1 + in.size());
+    const std::span<const float> history = window();
+    std::copy(history.begin() + 1, history.end(), scratch_.begin());
+    std::copy(in.begin(), in.end(), scratch_.begin() + static_cast<std::ptrdiff_t>(taps - 1));
+    block_(reversed_taps_.data(), taps, scratch_.data(), out.data(), out.size());
+    for (size_t j = in.size() - std::min(in.size(), taps); j < in.size(); ++j) {
+        store(in[j]);
+    }
+}
+
+std::span<const float> FirFilterRing::window() const {
+    return std::span<const float>(mirror_.data() + pos_, reversed_taps_.size());
+}
+
+void FirFilterRing::reset() {
+    std::fill(mirror_.begin(), mirror_.end(), 0.0f);
+    pos_ = 0;
+}
+
+size_t FirFilterRing::tap_count() const {
+    return reversed_taps_.size();
+}
+
+const char* FirFilterRing::instruction_set() const {
+    return instruction_set_;
+}
+
+std::vector<const char*> FirFilterRing::supported_instruction_sets() {
+    std::vector<const char*> names;
+    for (const Kernel& kernel : kernels()) {
+        names.push_back(kernel.name);
+    }
+    return names;
+}
+
+void FirFilterRing::store(float sample) {
+    // After the write, the window starts right after the newest sample: [pos_, pos_ + taps).
+    const size_t taps = reversed_taps_.size();
+    mirror_[pos_] = sample;
+    mirror_[pos_ + taps] = sample;
+    pos_ = pos_ + 1 == taps ? 0 : pos_ + 1;
+}
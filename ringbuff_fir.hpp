@@ -0,0 +1,62 @@
+#ifndef RING_BUFFER_FIR_HPP
+#define RING_BUFFER_FIR_HPP
+
+#include <cstddef>      // For size_t
+#include <span>         // For std::span
+#include <string_view>  // For std::string_view
+#include <vector>       // For std::vector
+
+// A streaming FIR filter: y[n] = sum over k of taps[k] * x[n - k].
+// The last taps.size() samples are kept twice, side by side (a mirrored
+// ring), so the window ending at the newest sample is always one contiguous
+// run of memory. Each output is then a single dot product with the reversed
+// taps, without per-tap wraparound, computed with AVX-512 or AVX2 FMA when
+// the CPU has them. Samples before the first push count as 0.
+class FirFilterRing {
+public:
+    // Constructs a filter with the given taps, taps[0] weighting the newest sample.
+    // An empty instruction_set picks the best the CPU has; otherwise it names one
+    // of supported_instruction_sets(), e.g. to compare kernels.
+    // Throws std::invalid_argument if taps is empty or instruction_set is not supported.
+    explicit FirFilterRing(std::span<const float> taps, std::string_view instruction_set = {});
+
+    // Adds a sample and returns the filter output for it.
+    float push(float sample);
+
+    // Block mode: filters in.size() samples into out, as if each was pushed in
+    // turn. Computes 8 or 16 consecutive outputs per vector straight from the
+    // input block, and writes only the last taps.size() samples to the window.
+    // Throws std::invalid_argument if out.size() != in.size().
+    void process(std::span<const float> in, std::span<float> out);
+
+    // Returns the last taps.size() samples, oldest first.
+    std::span<const float> window() const;
+
+    // Clears the window back to zeros.
+    void reset();
+
+    // Returns the number of taps.
+    size_t tap_count() const;
+
+    // Returns the instruction set this filter's dot products use: "avx512f", "avx2+fma" or "portable".
+    const char* instruction_set() const;
+
+    // Returns every instruction set this CPU can run, best first; "portable" is always last.
+    static std::vector<const char*> supported_instruction_sets();
+
+private:
+    using DotKernel = float (*)(const float* a, const float* b, size_t count);
+    using BlockKernel = void (*)(const float* taps, size_t tap_count, const float* x, float* out, size_t count);
+
+    void store(float sample);
+
+    std::vector<float> reversed_taps_;  // taps[0] last, to line up with the oldest-first window
+    std::vector<float> mirror_;         // Every sample at pos and pos + taps, 2 * taps floats
+    std::vector<float> scratch_;        // Window history plus input block for process()
+    size_t pos_ = 0;                    // Next slot of the first half to write
+    DotKernel dot_;                     // One output
+    BlockKernel block_;                 // Consecutive outputs, vectorized across outputs
+    const char* instruction_set_;
+};
+
+#endif // RING_BUFFER_FIR_HPP
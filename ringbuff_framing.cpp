@@ -0,0 +1,34 @@
+#include "ringbuff_framing.hpp"
+
+#include "ringbuff_crc32c.hpp"
+
+uint32_t frame_crc(uint64_t sequence, std::span<const std::byte> payload, std::span<const std::byte> rest) {
+    uint32_t crc = crc32c(&sequence, sizeof(sequence));
+    crc = crc32c(payload.data(), payload.size(), crc);
+    return crc32c(rest.data(), rest.size(), crc);
+}
+
+FrameCheck verify_frames(std::span<const std::byte> first, std::span<const std::byte> second,
+                         uint64_t after_sequence) {
+    FrameCheck check;
+    check.last_sequence = after_sequence;
+    const size_t total = first.size() + second.size();
+    size_t pos = 0;
+    while (total - pos >= frame_header_bytes) {
+        FrameHeader header;
+        framing_detail::copy_out(first, second, pos, &header, sizeof(header));
+        if (header.length > total - pos - frame_header_bytes || header.sequence <= check.last_sequence) {
+            break;
+        }
+        const auto [p, q] = framing_detail::slice(first, second, pos + frame_header_bytes, header.length);
+        if (frame_crc(header.sequence, p, q) != header.crc) {
+            break;
+        }
+        ++check.records;
+        check.last_sequence = header.sequence;
+        pos += frame_header_bytes + header.length;
+    }
+    check.valid_bytes = pos;
+    check.intact = pos == total;
+    return check;
+}
@@ -0,0 +1,178 @@
+#ifndef RING_BUFFER_FRAMING_HPP
+#define RING_BUFFER_FRAMING_HPP
+
+#include <algorithm>    // For std::min
+#include <cstddef>      // For size_t, std::byte
+#include <cstdint>      // For uint32_t, uint64_t
+#include <cstring>      // For std::memcpy
+#include <limits>       // For std::numeric_limits
+#include <span>         // For std::span, std::as_bytes
+#include <stdexcept>    // For std::invalid_argument, std::runtime_error
+#include <type_traits>  // For std::is_trivially_copyable_v
+#include <utility>      // For std::pair
+#include <vector>       // For std::vector
+
+#include "ringbuff.hpp"
+
+// Self-checking records for byte rings that are persisted, shared between
+// processes or replayed from disk.
+// Every record is a 16-byte header followed by the payload, in host byte order:
+// uint32 payload length, uint32 CRC-32C of the sequence and the payload, and
+// uint64 sequence. The Journal writes the same frames to its segment files.
+struct FrameHeader {
+    uint32_t length;    // Payload bytes following the header
+    uint32_t crc;       // CRC-32C of the sequence followed by the payload
+    uint64_t sequence;  // Strictly increasing record number
+};
+static_assert(sizeof(FrameHeader) == 16, "Frame header must be 16 bytes");
+
+inline constexpr size_t frame_header_bytes = sizeof(FrameHeader);
+
+// Result of a verify() pass.
+struct FrameCheck {
+    uint64_t records = 0;        // Intact records found
+    uint64_t last_sequence = 0;  // Sequence of the last intact record, or the starting point
+    size_t valid_bytes = 0;      // Length of the intact prefix
+    bool intact = true;          // Whether every byte belonged to an intact record
+};
+
+// Computes the checksum stored in a frame header. The payload may be split in
+// two pieces, as it is when a record wraps around the end of a ring.
+uint32_t frame_crc(uint64_t sequence, std::span<const std::byte> payload,
+                   std::span<const std::byte> rest = {});
+
+// Walks the frames stored in `first` followed by `second` and checks lengths,
+// checksums and that sequences increase past `after_sequence`. Stops at the
+// first torn or corrupt record.
+FrameCheck verify_frames(std::span<const std::byte> first, std::span<const std::byte> second = {},
+                         uint64_t after_sequence = 0);
+
+// Appends a framed record to a byte ring without overwriting.
+// Returns false, leaving the ring unchanged, if the whole frame does not fit.
+// Throws std::invalid_argument if the payload cannot be framed.
+template <typename Byte>
+bool try_push_frame(RingBuffer<Byte>& ring, uint64_t sequence, std::span<const std::byte> payload);
+
+// Removes the oldest framed record from a byte ring.
+// Returns false if the ring does not hold a complete frame yet.
+// Throws std::runtime_error, leaving the ring unchanged, if the frame fails its checksum.
+template <typename Byte>
+bool try_pop_frame(RingBuffer<Byte>& ring, uint64_t& sequence, std::vector<std::byte>& payload);
+
+// Checks every frame currently stored in a byte ring without consuming it.
+template <typename Byte>
+FrameCheck verify(const RingBuffer<Byte>& ring, uint64_t after_sequence = 0);
+
+namespace framing_detail {
+
+template <typename Byte>
+void check_byte_type() {
+    static_assert(sizeof(Byte) == 1 && std::is_trivially_copyable_v<Byte>,
+                  "Framed rings must hold single-byte elements");
+}
+
+// Copies `size` bytes starting `offset` bytes into the concatenation of two spans.
+inline void copy_out(std::span<const std::byte> first, std::span<const std::byte> second,
+                     size_t offset, void* out, size_t size) {
+    auto* dest = static_cast<std::byte*>(out);
+    if (offset < first.size()) {
+        const size_t n = std::min(size, first.size() - offset);
+        std::memcpy(dest, first.data() + offset, n);
+        dest += n;
+        size -= n;
+        offset = 0;
+    } else {
+        offset -= first.size();
+    }
+    if (size > 0) {
+        std::memcpy(dest, second.data() + offset, size);
+    }
+}
+
+// Copies `size` bytes to `offset` bytes into the concatenation of two spans.
+inline void copy_in(std::span<std::byte> first, std::span<std::byte> second,
+                    size_t offset, const void* in, size_t size) {
+    const auto* src = static_cast<const std::byte*>(in);
+    if (offset < first.size()) {
+        const size_t n = std::min(size, first.size() - offset);
+        std::memcpy(first.data() + offset, src, n);
+        src += n;
+        size -= n;
+        offset = 0;
+    } else {
+        offset -= first.size();
+    }
+    if (size > 0) {
+        std::memcpy(second.data() + offset, src, size);
+    }
+}
+
+// Splits `size` bytes starting `offset` bytes into two spans the same way.
+inline std::pair<std::span<const std::byte>, std::span<const std::byte>> slice(
+    std::span<const std::byte> first, std::span<const std::byte> second, size_t offset, size_t size) {
+    if (offset >= first.size()) {
+        return {second.subspan(offset - first.size(), size), {}};
+    }
+    const size_t head = std::min(size, first.size() - offset);
+    return {first.subspan(offset, head), second.first(size - head)};
+}
+
+}  // namespace framing_detail
+
+template <typename Byte>
+bool try_push_frame(RingBuffer<Byte>& ring, uint64_t sequence, std::span<const std::byte> payload) {
+    framing_detail::check_byte_type<Byte>();
+    if (payload.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument("Frame payload exceeds 4 GiB.");
+    }
+    auto [first, second] = ring.free_segments();
+    const size_t frame_size = frame_header_bytes + payload.size();
+    if (first.size() + second.size() < frame_size) {
+        return false;
+    }
+
+    const FrameHeader header{static_cast<uint32_t>(payload.size()), frame_crc(sequence, payload), sequence};
+    const std::span<std::byte> a = std::as_writable_bytes(first);
+    const std::span<std::byte> b = std::as_writable_bytes(second);
+    framing_detail::copy_in(a, b, 0, &header, sizeof(header));
+    framing_detail::copy_in(a, b, sizeof(header), payload.data(), payload.size());
+    ring.commit(frame_size);
+    return true;
+}
+
+template <typename Byte>
+bool try_pop_frame(RingBuffer<Byte>& ring, uint64_t& sequence, std::vector<std::byte>& payload) {
+    framing_detail::check_byte_type<Byte>();
+    const auto [first, second] = ring.segments();
+    const std::span<const std::byte> a = std::as_bytes(first);
+    const std::span<const std::byte> b = std::as_bytes(second);
+    if (a.size() + b.size() < frame_header_bytes) {
+        return false;
+    }
+    FrameHeader header;
+    framing_detail::copy_out(a, b, 0, &header, sizeof(header));
+    if (header.length > a.size() + b.size() - frame_header_bytes) {
+        if (frame_header_bytes + header.length > ring.capacity()) {
+            throw std::runtime_error("Frame length exceeds the ring capacity.");
+        }
+        return false;
+    }
+    const auto [p, q] = framing_detail::slice(a, b, frame_header_bytes, header.length);
+    if (frame_crc(header.sequence, p, q) != header.crc) {
+        throw std::runtime_error("Frame checksum mismatch.");
+    }
+    payload.resize(header.length);
+    framing_detail::copy_out(a, b, frame_header_bytes, payload.data(), header.length);
+    sequence = header.sequence;
+    ring.discard(frame_header_bytes + header.length);
+    return true;
+}
+
+template <typename Byte>
+FrameCheck verify(const RingBuffer<Byte>& ring, uint64_t after_sequence) {
+    framing_detail::check_byte_type<Byte>();
+    const auto [first, second] = ring.segments();
+    return verify_frames(std::as_bytes(first), std::as_bytes(second), after_sequence);
+}
+
+#endif // RING_BUFFER_FRAMING_HPP
@@ -0,0 +1,223 @@
+#ifndef RING_BUFFER_JOIN_HPP
+#define RING_BUFFER_JOIN_HPP
+
+#include <cstddef>        // For size_t
+#include <cstdint>        // For uint64_t
+#include <functional>     // For std::hash
+#include <stdexcept>      // For std::invalid_argument
+#include <unordered_map>  // For std::unordered_map
+#include <utility>        // For std::forward, std::move
+#include <vector>         // For std::vector
+
+#include "ringbuff.hpp"
+
+// Joins two streams on a key within a window, such as orders and fills that
+// belong together when they arrive within 500 ms of each other.
+// Each side keeps its recent items in a RingBuffer and indexes them by key, so
+// an arriving item is matched against the other side's items with the same
+// key only: a push costs O(matches) rather than O(window). Matches are
+// reported as they are found. Expired items are purged every purge_batch
+// pushes, oldest first; until then the probe skips them.
+// Timestamps can be times or sequence numbers, in the same unit as the window,
+// and should not decrease on either side. L, R and Key must be default
+// constructible. Not thread-safe.
+template <typename L, typename R, typename Key, typename Hash = std::hash<Key>>
+class WindowJoin {
+public:
+    // Constructs a join matching items whose timestamps differ by at most
+    // `window`, keeping up to `capacity` items per side.
+    // Throws std::invalid_argument if capacity or purge_batch is 0.
+    WindowJoin(uint64_t window, size_t capacity, size_t purge_batch = 64);
+
+    // Adds an item to the left side and calls on_match(const L&, const R&) for
+    // every right item with the same key inside the window, newest first.
+    // Returns the number of matches.
+    template <typename Fn>
+    size_t push_left(const Key& key, uint64_t timestamp, L item, Fn&& on_match);
+
+    // Adds an item to the right side and calls on_match(const L&, const R&) for
+    // every left item with the same key inside the window, newest first.
+    // Returns the number of matches.
+    template <typename Fn>
+    size_t push_right(const Key& key, uint64_t timestamp, R item, Fn&& on_match);
+
+    // Purges the items of both sides older than now - window.
+    void purge(uint64_t now);
+
+    // Returns the number of items held on the left side, including expired ones not yet purged.
+    size_t left_size() const;
+
+    // Returns the number of items held on the right side, including expired ones not yet purged.
+    size_t right_size() const;
+
+    // Returns the number of items dropped before they expired because a side was full.
+    uint64_t overflowed() const;
+
+private:
+    template <typename T>
+    struct Side {
+        struct Entry {
+            uint64_t timestamp;
+            Key key;
+            T item;
+        };
+
+        // Sequence numbers of the items with one key, oldest first from head.
+        struct Postings {
+            std::vector<uint64_t> sequences;
+            size_t head = 0;
+        };
+
+        explicit Side(size_t capacity) : ring(capacity) {}
+
+        // Adds an item, dropping the oldest first if the ring is full.
+        // Returns whether an item was dropped.
+        bool insert(const Key& key, uint64_t timestamp, T&& item);
+
+        // Purges items with timestamps below `before`.
+        void expire(uint64_t before);
+
+        // Calls visit(item) for every item with `key` and a timestamp within
+        // `window` of `timestamp`, newest first. Returns the number visited.
+        template <typename Visit>
+        size_t probe(const Key& key, uint64_t timestamp, uint64_t window, Visit&& visit) const;
+
+        void evict_oldest();
+
+        RingBuffer<Entry> ring;
+        std::unordered_map<Key, Postings, Hash> index;
+        uint64_t next_sequence = 0;  // Sequence number of the next item; the oldest is next_sequence - ring.size()
+    };
+
+    void after_push(uint64_t timestamp);
+
+    uint64_t window_;
+    size_t purge_batch_;
+    size_t since_purge_ = 0;  // Pushes since the last purge
+    uint64_t latest_ = 0;     // Highest timestamp pushed
+    uint64_t overflowed_ = 0;
+    Side<L> left_;
+    Side<R> right_;
+};
+
+template <typename L, typename R, typename Key, typename Hash>
+WindowJoin<L, R, Key, Hash>::WindowJoin(uint64_t window, size_t capacity, size_t purge_batch)
+    : window_(window), purge_batch_(purge_batch), left_(capacity), right_(capacity) {
+    if (purge_batch == 0) {
+        throw std::invalid_argument("WindowJoin purge batch must be greater than 0.");
+    }
+}
+
+template <typename L, typename R, typename Key, typename Hash>
+template <typename Fn>
+size_t WindowJoin<L, R, Key, Hash>::push_left(const Key& key, uint64_t timestamp, L item, Fn&& on_match) {
+    const size_t matches =
+        right_.probe(key, timestamp, window_, [&](const R& right) { on_match(static_cast<const L&>(item), right); });
+    overflowed_ += left_.insert(key, timestamp, std::move(item));
+    after_push(timestamp);
+    return matches;
+}
+
+template <typename L, typename R, typename Key, typename Hash>
+template <typename Fn>
+size_t WindowJoin<L, R, Key, Hash>::push_right(const Key& key, uint64_t timestamp, R item, Fn&& on_match) {
+    const size_t matches =
+        left_.probe(key, timestamp, window_, [&](const L& left) { on_match(left, static_cast<const R&>(item)); });
+    overflowed_ += right_.insert(key, timestamp, std::move(item));
+    after_push(timestamp);
+    return matches;
+}
+
+template <typename L, typename R, typename Key, typename Hash>
+void WindowJoin<L, R, Key, Hash>::purge(uint64_t now) {
+    const uint64_t before = now > window_ ? now - window_ : 0;
+    left_.expire(before);
+    right_.expire(before);
+    since_purge_ = 0;
+}
+
+template <typename L, typename R, typename Key, typename Hash>
+size_t WindowJoin<L, R, Key, Hash>::left_size() const {
+    return left_.ring.size();
+}
+
+template <typename L, typename R, typename Key, typename Hash>
+size_t WindowJoin<L, R, Key, Hash>::right_size() const {
+    return right_.ring.size();
+}
+
+template <typename L, typename R, typename Key, typename Hash>
+uint64_t WindowJoin<L, R, Key, Hash>::overflowed() const {
+    return overflowed_;
+}
+
+template <typename L, typename R, typename Key, typename Hash>
+void WindowJoin<L, R, Key, Hash>::after_push(uint64_t timestamp) {
+    if (timestamp > latest_) {
+        latest_ = timestamp;
+    }
+    if (++since_purge_ >= purge_batch_) {
+        purge(latest_);
+    }
+}
+
+template <typename L, typename R, typename Key, typename Hash>
+template <typename T>
+bool WindowJoin<L, R, Key, Hash>::Side<T>::insert(const Key& key, uint64_t timestamp, T&& item) {
+    const bool dropped = ring.full();
+    if (dropped) {
+        evict_oldest();
+    }
+    ring.push(Entry{timestamp, key, std::move(item)});
+    index[key].sequences.push_back(next_sequence++);
+    return dropped;
+}
+
+template <typename L, typename R, typename Key, typename Hash>
+template <typename T>
+void WindowJoin<L, R, Key, Hash>::Side<T>::expire(uint64_t before) {
+    while (!ring.empty() && ring.front().timestamp < before) {
+        evict_oldest();
+    }
+}
+
+template <typename L, typename R, typename Key, typename Hash>
+template <typename T>
+template <typename Visit>
+size_t WindowJoin<L, R, Key, Hash>::Side<T>::probe(const Key& key, uint64_t timestamp, uint64_t window,
+                                                    Visit&& visit) const {
+    auto found = index.find(key);
+    if (found == index.end()) {
+        return 0;
+    }
+    const Postings& postings = found->second;
+    const uint64_t oldest = next_sequence - ring.size();
+    size_t matches = 0;
+    for (size_t i = postings.sequences.size(); i-- > postings.head;) {
+        const Entry& entry = ring.at(postings.sequences[i] - oldest);
+        if (entry.timestamp + window < timestamp) {
+            break;  // Everything older is outside the window too.
+        }
+        if (entry.timestamp <= timestamp + window) {
+            visit(entry.item);
+            ++matches;
+        }
+    }
+    return matches;
+}
+
+template <typename L, typename R, typename Key, typename Hash>
+template <typename T>
+void WindowJoin<L, R, Key, Hash>::Side<T>::evict_oldest() {
+    auto found = index.find(ring.front().key);
+    Postings& postings = found->second;
+    if (++postings.head == postings.sequences.size()) {
+        index.erase(found);
+    } else if (postings.head >= 32 && postings.head * 2 >= postings.sequences.size()) {
+        postings.sequences.erase(postings.sequences.begin(), postings.sequences.begin() + postings.head);
+        postings.head = 0;
+    }
+    ring.discard(1);
+}
+
+#endif // RING_BUFFER_JOIN_HPP
@@ -0,0 +1,348 @@
+#include "ringbuff_journal.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+namespace {
+
+std::string segment_name(const std::string& prefix, uint64_t first_sequence) {
+    char digits[32];
+    std::snprintf(digits, sizeof(digits), "%020" PRIu64, first_sequence);
+    return prefix + "-" + digits + ".log";
+}
+
+// Segment files of a journal ordered by their first sequence number.
+std::vector<std::pair<uint64_t, std::filesystem::path>> list_segments(const JournalOptions& options) {
+    namespace fs = std::filesystem;
+    std::vector<std::pair<uint64_t, fs::path>> segments;
+    std::error_code ec;
+    const std::string head = options.prefix + "-";
+    for (fs::directory_iterator it(options.directory, ec), end; !ec && it != end; it.increment(ec)) {
+        const std::string name = it->path().filename().string();
+        if (name.size() != head.size() + 20 + 4 || name.compare(0, head.size(), head) != 0 ||
+            name.compare(name.size() - 4, 4, ".log") != 0) {
+            continue;
+        }
+        const std::string digits = name.substr(head.size(), 20);
+        if (!std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            continue;
+        }
+        segments.emplace_back(std::stoull(digits), it->path());
+    }
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+// Walks the intact frames of one segment. Returns the byte length of the
+// intact prefix and sets `last_sequence` to the sequence of its last record.
+size_t scan_segment(const std::filesystem::path& path, uint64_t& last_sequence,
+                    const std::function<void(uint64_t, std::span<const std::byte>)>* visit) {
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "Journal cannot open " + path.string());
+    }
+    std::vector<std::byte> data;
+    std::byte chunk[1 << 16];
+    for (;;) {
+        const ssize_t n = read(fd, chunk, sizeof(chunk));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            const int error = errno;
+            close(fd);
+            throw std::system_error(error, std::generic_category(), "Journal cannot read " + path.string());
+        }
+        if (n == 0) {
+            break;
+        }
+        data.insert(data.end(), chunk, chunk + n);
+    }
+    close(fd);
+
+    size_t pos = 0;
+    while (data.size() - pos >= sizeof(FrameHeader)) {
+        FrameHeader header;
+        std::memcpy(&header, data.data() + pos, sizeof(header));
+        const std::byte* payload = data.data() + pos + sizeof(header);
+        if (header.length > data.size() - pos - sizeof(header) ||
+            header.sequence <= last_sequence ||
+            frame_crc(header.sequence, std::span<const std::byte>(payload, header.length)) != header.crc) {
+            break;
+        }
+        if (visit != nullptr) {
+            (*visit)(header.sequence, std::span<const std::byte>(payload, header.length));
+        }
+        last_sequence = header.sequence;
+        pos += sizeof(header) + header.length;
+    }
+    return pos;
+}
+
+void sync_directory(const std::string& directory) {
+    const int fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+}
+
+}  // namespace
+
+Journal::Journal(JournalOptions options)
+    : options_(std::move(options)), queue_(std::max<size_t>(options_.queue_capacity, 1)) {
+    if (options_.directory.empty()) {
+        throw std::invalid_argument("Journal directory must not be empty.");
+    }
+    if (options_.queue_capacity == 0 || options_.segment_bytes <= frame_header_bytes) {
+        throw std::invalid_argument("Journal queue capacity and segment size must be positive.");
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(options_.directory, ec);
+    if (ec) {
+        throw std::system_error(ec, "Journal cannot create " + options_.directory);
+    }
+
+    // Continue after the last intact record, cutting off any torn tail.
+    // Earlier segments were completed and synced before the last one was created.
+    uint64_t last_sequence = 0;
+    const auto segments = list_segments(options_);
+    if (!segments.empty()) {
+        const auto& [first, path] = segments.back();
+        last_sequence = first - 1;
+        const size_t intact = scan_segment(path, last_sequence, nullptr);
+        segment_fd_ = open(path.c_str(), O_WRONLY | O_CLOEXEC);
+        if (segment_fd_ < 0 || ftruncate(segment_fd_, static_cast<off_t>(intact)) != 0 ||
+            lseek(segment_fd_, static_cast<off_t>(intact), SEEK_SET) < 0) {
+            const int error = errno;
+            if (segment_fd_ >= 0) {
+                close(segment_fd_);
+            }
+            throw std::system_error(error, std::generic_category(), "Journal cannot reopen " + path.string());
+        }
+        segment_size_ = intact;
+    }
+    next_sequence_ = last_sequence + 1;
+    durable_sequence_.store(last_sequence, std::memory_order_relaxed);
+    if (segment_fd_ < 0) {
+        open_segment(next_sequence_);
+    }
+
+    writer_ = std::thread([this] { run(); });
+}
+
+Journal::~Journal() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    queued_.notify_one();
+    writer_.join();
+    if (segment_fd_ >= 0) {
+        close(segment_fd_);
+    }
+}
+
+uint64_t Journal::append(std::span<const std::byte> payload) {
+    if (payload.size() > UINT32_MAX || payload.size() > options_.segment_bytes - frame_header_bytes) {
+        throw std::invalid_argument("Journal record does not fit in a segment.");
+    }
+    Pending record;
+    record.payload.assign(payload.begin(), payload.end());
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    space_.wait(lock, [this] { return !queue_.full() || error_ != 0; });
+    check_failed();
+    record.sequence = next_sequence_++;
+    const uint64_t sequence = record.sequence;
+    const bool first = queue_.empty();
+    queued_bytes_ += payload.size();
+    const bool batch_ready = queued_bytes_ >= options_.batch_bytes;
+    queue_.push(std::move(record));
+    lock.unlock();
+
+    // The writer only needs a wake-up to start a batch timer or to cut one short.
+    if (first || batch_ready) {
+        queued_.notify_one();
+    }
+    return sequence;
+}
+
+void Journal::wait_durable(uint64_t sequence) {
+    if (durable_sequence_.load(std::memory_order_acquire) >= sequence) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    durable_.wait(lock, [this, sequence] {
+        return durable_sequence_.load(std::memory_order_acquire) >= sequence || error_ != 0;
+    });
+    if (durable_sequence_.load(std::memory_order_acquire) < sequence) {
+        check_failed();
+    }
+}
+
+void Journal::flush() {
+    uint64_t last;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        last = next_sequence_ - 1;
+        flush_through_ = std::max(flush_through_, last);
+    }
+    queued_.notify_one();
+    wait_durable(last);
+}
+
+uint64_t Journal::durable_sequence() const {
+    return durable_sequence_.load(std::memory_order_acquire);
+}
+
+uint64_t Journal::next_sequence() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return next_sequence_;
+}
+
+uint64_t Journal::replay(const JournalOptions& options,
+                         const std::function<void(uint64_t, std::span<const std::byte>)>& visit) {
+    uint64_t last_sequence = 0;
+    uint64_t records = 0;
+    const std::function<void(uint64_t, std::span<const std::byte>)> counted =
+        [&](uint64_t sequence, std::span<const std::byte> payload) {
+            ++records;
+            visit(sequence, payload);
+        };
+    for (auto& [first, path] : list_segments(options)) {
+        std::error_code ec;
+        const size_t size = std::filesystem::file_size(path, ec);
+        if (scan_segment(path, last_sequence, &counted) != size) {
+            break;
+        }
+    }
+    return records;
+}
+
+void Journal::run() {
+    std::vector<Pending> batch;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        queued_.wait(lock, [this] { return stopping_ || !queue_.empty() || error_ != 0; });
+        if (error_ != 0 || (stopping_ && queue_.empty())) {
+            break;
+        }
+
+        // Group commit: hold the batch open until it is big enough, old enough,
+        // or someone is waiting for it.
+        const auto deadline = std::chrono::steady_clock::now() + options_.max_delay;
+        queued_.wait_until(lock, deadline, [this] {
+            return stopping_ || queued_bytes_ >= options_.batch_bytes ||
+                   flush_through_ >= next_sequence_ - 1;
+        });
+
+        Pending record;
+        while (queue_.try_pop(record)) {
+            batch.push_back(std::move(record));
+        }
+        queued_bytes_ = 0;
+        lock.unlock();
+        space_.notify_all();
+
+        try {
+            write_batch(batch);
+        } catch (const std::system_error& e) {
+            lock.lock();
+            fail(e.code().value());
+            break;
+        }
+        const uint64_t durable = batch.back().sequence;
+        batch.clear();
+
+        lock.lock();
+        durable_sequence_.store(durable, std::memory_order_release);
+        durable_.notify_all();
+        if (options_.on_durable) {
+            lock.unlock();
+            options_.on_durable(durable);
+            lock.lock();
+        }
+    }
+}
+
+void Journal::write_batch(std::vector<Pending>& batch) {
+    frames_.clear();
+    for (const Pending& record : batch) {
+        const size_t frame_size = frame_header_bytes + record.payload.size();
+        if (segment_size_ + frames_.size() + frame_size > options_.segment_bytes &&
+            segment_size_ + frames_.size() > 0) {
+            // Frames never straddle segments: finish this one and start the next.
+            write_all(frames_.data(), frames_.size());
+            frames_.clear();
+            if (fdatasync(segment_fd_) != 0) {
+                throw std::system_error(errno, std::generic_category(), "Journal fdatasync");
+            }
+            open_segment(record.sequence);
+        }
+        FrameHeader header{static_cast<uint32_t>(record.payload.size()),
+                           frame_crc(record.sequence, record.payload),
+                           record.sequence};
+        const auto* raw = reinterpret_cast<const std::byte*>(&header);
+        frames_.insert(frames_.end(), raw, raw + sizeof(header));
+        frames_.insert(frames_.end(), record.payload.begin(), record.payload.end());
+    }
+    write_all(frames_.data(), frames_.size());
+    if (fdatasync(segment_fd_) != 0) {
+        throw std::system_error(errno, std::generic_category(), "Journal fdatasync");
+    }
+}
+
+void Journal::open_segment(uint64_t first_sequence) {
+    const std::filesystem::path path =
+        std::filesystem::path(options_.directory) / segment_name(options_.prefix, first_sequence);
+    const int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "Journal cannot create " + path.string());
+    }
+    if (segment_fd_ >= 0) {
+        close(segment_fd_);
+    }
+    segment_fd_ = fd;
+    segment_size_ = 0;
+    // Make the new directory entry durable along with the first batch in it.
+    sync_directory(options_.directory);
+}
+
+void Journal::write_all(const std::byte* data, size_t size) {
+    while (size > 0) {
+        const ssize_t n = write(segment_fd_, data, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            throw std::system_error(errno, std::generic_category(), "Journal write");
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+        segment_size_ += static_cast<size_t>(n);
+    }
+}
+
+void Journal::fail(int error) {
+    error_ = error;
+    space_.notify_all();
+    durable_.notify_all();
+}
+
+void Journal::check_failed() const {
+    if (error_ != 0) {
+        throw std::system_error(error_, std::generic_category(), "Journal writer failed");
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef RING_BUFFER_JOURNAL_HPP
+#define RING_BUFFER_JOURNAL_HPP
+
+#include <atomic>              // For std::atomic
+#include <chrono>              // For std::chrono::microseconds
+#include <condition_variable>  // For std::condition_variable
+#include <cstddef>             // For size_t, std::byte
+#include <cstdint>             // For uint32_t, uint64_t
+#include <functional>          // For std::function
+#include <mutex>               // For std::mutex
+#include <span>                // For std::span
+#include <string>              // For std::string
+#include <thread>              // For std::thread
+#include <vector>              // For std::vector
+
+#include "ringbuff.hpp"
+#include "ringbuff_framing.hpp"
+
+// Settings for a Journal.
+struct JournalOptions {
+    std::string directory;                        // Where segment files live; created if missing
+    std::string prefix = "journal";               // Segment files are <prefix>-<first sequence>.log
+    size_t segment_bytes = 64u << 20;             // Start a new segment file beyond this size
+    size_t batch_bytes = 1u << 20;                // Commit as soon as this many payload bytes are queued
+    std::chrono::microseconds max_delay{1000};    // Commit at the latest this long after the first queued record
+    size_t queue_capacity = 65536;                // Records buffered between producers and the writer
+    std::function<void(uint64_t)> on_durable;     // Called from the writer with the last durable sequence
+};
+
+// An append-only durable journal fed through a ring.
+// Producers append records into a RingBuffer and get a sequence number back
+// immediately. A writer thread drains the ring, frames each record with its
+// length, sequence and CRC-32C, appends the frames to the current segment file
+// and makes the whole batch durable with a single fdatasync (group commit).
+// A batch closes when batch_bytes are queued or max_delay has passed, so the
+// cost of a sync is shared by every record that arrived in the meantime.
+//
+// On disk every record is a frame as described in ringbuff_framing.hpp.
+// Opening an existing journal truncates a torn tail left by a crash and
+// continues after the last intact record.
+class Journal {
+public:
+    // Opens or creates the journal described by options and starts the writer.
+    // Throws std::invalid_argument for unusable options and std::system_error
+    // if the directory or segment files cannot be opened.
+    explicit Journal(JournalOptions options);
+
+    // Commits every appended record, then stops the writer.
+    ~Journal();
+
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    // Queues a record and returns its sequence number.
+    // Blocks while the ring is full. Throws std::system_error if the writer has failed.
+    uint64_t append(std::span<const std::byte> payload);
+
+    // Blocks until the record with the given sequence number is durable.
+    // Throws std::system_error if the writer fails first.
+    void wait_durable(uint64_t sequence);
+
+    // Commits everything appended so far without waiting for the batch thresholds
+    // and blocks until it is durable.
+    void flush();
+
+    // Returns the highest sequence number known to be durable (0 if none).
+    uint64_t durable_sequence() const;
+
+    // Returns the sequence number the next appended record will get.
+    uint64_t next_sequence() const;
+
+    // Reads every intact record of the journal described by options in order,
+    // stopping at the first torn or corrupt frame. Returns the number of records read.
+    static uint64_t replay(const JournalOptions& options,
+                           const std::function<void(uint64_t, std::span<const std::byte>)>& visit);
+
+private:
+    struct Pending {
+        uint64_t sequence = 0;
+        std::vector<std::byte> payload;
+    };
+
+    void run();
+    void write_batch(std::vector<Pending>& batch);
+    void open_segment(uint64_t first_sequence);
+    void write_all(const std::byte* data, size_t size);
+    void fail(int error);
+    void check_failed() const;
+
+    JournalOptions options_;
+    RingBuffer<Pending> queue_;                  // Records waiting for the writer
+    mutable std::mutex mutex_;                   // Guards queue_ and the fields below
+    std::condition_variable queued_;             // Signals the writer
+    std::condition_variable space_;              // Signals producers waiting for room
+    std::condition_variable durable_;            // Signals wait_durable() callers
+    uint64_t next_sequence_ = 1;
+    size_t queued_bytes_ = 0;                    // Payload bytes in queue_
+    uint64_t flush_through_ = 0;                 // Commit immediately up to this sequence
+    bool stopping_ = false;
+    int error_ = 0;                              // errno of the first write failure
+    std::atomic<uint64_t> durable_sequence_{0};
+
+    int segment_fd_ = -1;                        // Current segment file, writer only
+    size_t segment_size_ = 0;                    // Bytes in the current segment, writer only
+    std::vector<std::byte> frames_;              // Reused framing buffer, writer only
+    std::thread writer_;
+};
+
+#endif // RING_BUFFER_JOURNAL_HPP
@@ -0,0 +1,234 @@
+#include "ringbuff_lz4.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+constexpr size_t min_match = 4;
+constexpr size_t last_literals = 5;   // The block always ends with at least this many literals
+constexpr size_t match_find_limit = 12;  // No match may start within this many bytes of the end
+constexpr size_t max_offset = 65535;
+constexpr int hash_log = 12;
+constexpr unsigned skip_trigger = 6;   // Widen the search step after 2^6 misses
+
+uint32_t read32(const uint8_t* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint64_t read64(const uint8_t* p) {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t hash(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - hash_log);
+}
+
+// Length of the common prefix of a and b, reading no further than a_limit.
+size_t common_length(const uint8_t* a, const uint8_t* b, const uint8_t* a_limit) {
+    const uint8_t* const start = a;
+    while (a + sizeof(uint64_t) <= a_limit) {
+        const uint64_t diff = read64(a) ^ read64(b);
+        if (diff != 0) {
+            if constexpr (std::endian::native == std::endian::little) {
+                return static_cast<size_t>(a - start) + (static_cast<size_t>(__builtin_ctzll(diff)) >> 3);
+            } else {
+                return static_cast<size_t>(a - start) + (static_cast<size_t>(__builtin_clzll(diff)) >> 3);
+            }
+        }
+        a += sizeof(uint64_t);
+        b += sizeof(uint64_t);
+    }
+    while (a < a_limit && *a == *b) {
+        ++a;
+        ++b;
+    }
+    return static_cast<size_t>(a - start);
+}
+
+// Writes the 255-run extension of a length field whose nibble saturated at 15.
+uint8_t* write_length(uint8_t* out, size_t length) {
+    for (length -= 15; length >= 255; length -= 255) {
+        *out++ = 255;
+    }
+    *out++ = static_cast<uint8_t>(length);
+    return out;
+}
+
+size_t read_length(const uint8_t*& in, const uint8_t* in_end) {
+    size_t length = 15;
+    uint8_t byte;
+    do {
+        if (in >= in_end) {
+            throw std::runtime_error("LZ4 block truncated in a length field.");
+        }
+        byte = *in++;
+        length += byte;
+    } while (byte == 255);
+    return length;
+}
+
+}  // namespace
+
+size_t lz4_compress_bound(size_t size) {
+    return size + size / 255 + 16;
+}
+
+size_t lz4_compress(const void* source, size_t size, void* dest, size_t capacity) {
+    if (size > UINT32_MAX) {
+        return 0;  // Positions in the match table are 32-bit
+    }
+    const auto* const src = static_cast<const uint8_t*>(source);
+    const uint8_t* const end = src + size;
+    auto* const dst = static_cast<uint8_t*>(dest);
+    uint8_t* out = dst;
+    uint8_t* const out_end = dst + capacity;
+    const uint8_t* anchor = src;
+
+    if (size > match_find_limit) {
+        uint32_t table[1 << hash_log] = {};  // Last position of each hashed 4-byte sequence
+        const uint8_t* const match_limit = end - last_literals;
+        const uint8_t* const input_limit = end - match_find_limit;
+        const uint8_t* ip = src + 1;
+
+        while (ip < input_limit) {
+            // Find the next match, stepping faster through data that does not compress.
+            const uint8_t* match;
+            unsigned attempts = 1u << skip_trigger;
+            for (;;) {
+                const uint32_t h = hash(read32(ip));
+                match = src + table[h];
+                table[h] = static_cast<uint32_t>(ip - src);
+                if (static_cast<size_t>(ip - match) <= max_offset && read32(match) == read32(ip) && match < ip) {
+                    break;
+                }
+                ip += attempts++ >> skip_trigger;
+                if (ip >= input_limit) {
+                    goto finish;
+                }
+            }
+            while (ip > anchor && match > src && ip[-1] == match[-1]) {
+                --ip;
+                --match;
+            }
+
+            const size_t literals = static_cast<size_t>(ip - anchor);
+            const size_t match_length = min_match + common_length(ip + min_match, match + min_match, match_limit);
+            if (static_cast<size_t>(out_end - out) <
+                1 + literals + literals / 255 + 1 + 2 + match_length / 255 + 1) {
+                return 0;
+            }
+
+            uint8_t* token = out++;
+            *token = static_cast<uint8_t>((literals >= 15 ? 15 : literals) << 4);
+            if (literals >= 15) {
+                out = write_length(out, literals);
+            }
+            std::memcpy(out, anchor, literals);
+            out += literals;
+            const size_t offset = static_cast<size_t>(ip - match);
+            *out++ = static_cast<uint8_t>(offset);
+            *out++ = static_cast<uint8_t>(offset >> 8);
+            const size_t extra = match_length - min_match;
+            *token |= static_cast<uint8_t>(extra >= 15 ? 15 : extra);
+            if (extra >= 15) {
+                out = write_length(out, extra);
+            }
+
+            ip += match_length;
+            anchor = ip;
+            if (ip < input_limit) {
+                table[hash(read32(ip - 2))] = static_cast<uint32_t>(ip - 2 - src);
+            }
+        }
+    }
+
+finish:
+    const size_t literals = static_cast<size_t>(end - anchor);
+    if (static_cast<size_t>(out_end - out) < 1 + literals + literals / 255 + 1) {
+        return 0;
+    }
+    *out++ = static_cast<uint8_t>((literals >= 15 ? 15 : literals) << 4);
+    if (literals >= 15) {
+        out = write_length(out, literals);
+    }
+    if (literals > 0) {
+        std::memcpy(out, anchor, literals);
+        out += literals;
+    }
+    return static_cast<size_t>(out - dst);
+}
+
+size_t lz4_decompress(const void* source, size_t size, void* dest, size_t capacity) {
+    const auto* in = static_cast<const uint8_t*>(source);
+    const uint8_t* const in_end = in + size;
+    auto* const dst = static_cast<uint8_t*>(dest);
+    uint8_t* out = dst;
+    uint8_t* const out_end = dst + capacity;
+
+    for (;;) {
+        if (in >= in_end) {
+            throw std::runtime_error("LZ4 block truncated.");
+        }
+        const uint8_t token = *in++;
+
+        size_t literals = token >> 4;
+        if (literals == 15) {
+            literals = read_length(in, in_end);
+        }
+        if (literals > static_cast<size_t>(in_end - in) || literals > static_cast<size_t>(out_end - out)) {
+            throw std::runtime_error("LZ4 literals run past the block.");
+        }
+        if (literals <= 16 && in_end - in >= 16 && out_end - out >= 16) {
+            std::memcpy(out, in, 16);  // Fixed-size copy of a short run; the excess is overwritten
+        } else if (literals > 0) {
+            std::memcpy(out, in, literals);  // out may be null when capacity is 0
+        }
+        in += literals;
+        out += literals;
+        if (in == in_end) {
+            break;  // The last sequence has no match part
+        }
+
+        if (in_end - in < 2) {
+            throw std::runtime_error("LZ4 block truncated in an offset.");
+        }
+        const size_t offset = in[0] | (static_cast<size_t>(in[1]) << 8);
+        in += 2;
+        if (offset == 0 || offset > static_cast<size_t>(out - dst)) {
+            throw std::runtime_error("LZ4 match offset out of range.");
+        }
+        size_t length = token & 15;
+        if (length == 15) {
+            length = read_length(in, in_end);
+        }
+        length += min_match;
+        if (length > static_cast<size_t>(out_end - out)) {
+            throw std::runtime_error("LZ4 match runs past the output.");
+        }
+
+        const uint8_t* match = out - offset;
+        if (offset >= sizeof(uint64_t) && static_cast<size_t>(out_end - out) >= length + sizeof(uint64_t)) {
+            // Copy whole words; the overshoot lands in space the output still has.
+            uint8_t* const copy_end = out + length;
+            while (out < copy_end) {
+                std::memcpy(out, match, sizeof(uint64_t));
+                out += sizeof(uint64_t);
+                match += sizeof(uint64_t);
+            }
+            out = copy_end;
+        } else {
+            for (size_t i = 0; i < length; ++i) {
+                out[i] = match[i];
+            }
+            out += length;
+        }
+    }
+    return static_cast<size_t>(out - dst);
+}
@@ -0,0 +1,23 @@
+#ifndef RING_BUFFER_LZ4_HPP
+#define RING_BUFFER_LZ4_HPP
+
+#include <cstddef>  // For size_t
+
+// A self-contained compressor for the LZ4 block format, used to shrink ring
+// segments on their way to disk. Output is readable by any LZ4 block decoder
+// (LZ4_decompress_safe) and vice versa.
+
+// Returns the largest compressed size an input of `size` bytes can produce.
+size_t lz4_compress_bound(size_t size);
+
+// Compresses `size` bytes from source into dest, which has room for `capacity` bytes.
+// Returns the compressed size, or 0 if the result would not fit, in which case the
+// caller should store the data uncompressed.
+size_t lz4_compress(const void* source, size_t size, void* dest, size_t capacity);
+
+// Decompresses one block of `size` bytes into dest, which has room for `capacity` bytes.
+// Returns the decompressed size.
+// Throws std::runtime_error if the block is malformed or does not fit.
+size_t lz4_decompress(const void* source, size_t size, void* dest, size_t capacity);
+
+#endif // RING_BUFFER_LZ4_HPP
@@ -0,0 +1,42 @@
+#ifndef RING_BUFFER_MEMORY_ORDER_HPP
+#define RING_BUFFER_MEMORY_ORDER_HPP
+
+#include <atomic>  // For std::memory_order
+
+// Memory orders used by the concurrent ring variants.
+// Each atomic operation in MpmcRingBuffer, TaggedRingBuffer, UnboundedRing and
+// EpochDomain names the weakest order that keeps it correct. Defining
+// RING_STRICT_SEQCST before including any of them (or on the compiler command
+// line) turns every one of those orders into seq_cst, which is useful to rule
+// out an ordering bug or to measure what the relaxed orders buy.
+// The definition must be the same in every translation unit.
+namespace ring_order {
+
+#ifdef RING_STRICT_SEQCST
+inline constexpr std::memory_order relaxed = std::memory_order_seq_cst;
+inline constexpr std::memory_order acquire = std::memory_order_seq_cst;
+inline constexpr std::memory_order release = std::memory_order_seq_cst;
+inline constexpr std::memory_order acq_rel = std::memory_order_seq_cst;
+#else
+inline constexpr std::memory_order relaxed = std::memory_order_relaxed;
+inline constexpr std::memory_order acquire = std::memory_order_acquire;
+inline constexpr std::memory_order release = std::memory_order_release;
+inline constexpr std::memory_order acq_rel = std::memory_order_acq_rel;
+#endif
+inline constexpr std::memory_order seq_cst = std::memory_order_seq_cst;
+
+inline constexpr bool strict = seq_cst == relaxed;
+
+// The same order as an argument for the GCC/Clang __atomic builtins.
+constexpr int builtin(std::memory_order order) {
+    return static_cast<int>(order);
+}
+
+static_assert(builtin(std::memory_order_acquire) == __ATOMIC_ACQUIRE &&
+                  builtin(std::memory_order_acq_rel) == __ATOMIC_ACQ_REL &&
+                  builtin(std::memory_order_seq_cst) == __ATOMIC_SEQ_CST,
+              "std::memory_order must match the __atomic builtin constants");
+
+}  // namespace ring_order
+
+#endif // RING_BUFFER_MEMORY_ORDER_HPP
@@ -0,0 +1,300 @@
+#ifndef RING_BUFFER_MERGE_HPP
+#define RING_BUFFER_MERGE_HPP
+
+#include <algorithm>    // For std::min
+#include <cstddef>      // For size_t
+#include <functional>   // For std::invoke
+#include <limits>       // For std::numeric_limits
+#include <span>         // For std::span
+#include <stdexcept>    // For std::invalid_argument, std::out_of_range
+#include <type_traits>  // For std::invoke_result_t, std::decay_t
+#include <utility>      // For std::move, std::swap
+#include <vector>       // For std::vector
+
+#include "ringbuff.hpp"
+
+// Merges several rings, each ordered by timestamp, into one time-ordered
+// stream, such as per-venue feeds replayed as a single sequence.
+// A loser tree over the rings' front timestamps finds the earliest element
+// with about log2(N) comparisons per pop, instead of comparing every ring's
+// front. consume() hands over whole runs from one ring: the run continues
+// while its elements precede the runner-up on the tree path, so they are
+// taken without further comparisons.
+// timestamp_of(const T&) returns a default-constructible timestamp ordered by
+// operator<. Equal timestamps come out in ring order, lowest index first.
+// A ring that runs empty drops out of the merge; after pushing to a ring other
+// than through this reader, call refresh(). Not thread-safe.
+template <typename T, typename TimestampOf>
+class MergedRingReader {
+public:
+    using Timestamp = std::decay_t<std::invoke_result_t<const TimestampOf&, const T&>>;
+
+    // Constructs a reader over the rings, which must outlive it.
+    // Throws std::invalid_argument if rings is empty or holds a null pointer.
+    explicit MergedRingReader(std::vector<RingBuffer<T>*> rings, TimestampOf timestamp_of = TimestampOf());
+
+    // Returns the earliest element without removing it.
+    // Throws std::out_of_range if every ring is empty.
+    const T& front() const;
+
+    // Returns the index of the ring holding the earliest element.
+    // Throws std::out_of_range if every ring is empty.
+    size_t front_ring() const;
+
+    // Removes and returns the earliest element.
+    // Throws std::out_of_range if every ring is empty.
+    T pop();
+
+    // Removes the earliest element into out_item.
+    // Returns true if successful, false if every ring is empty.
+    bool try_pop(T& out_item);
+
+    // Removes up to max_count elements in timestamp order, passing each to fn
+    // as an rvalue, and returns how many were removed. Runs from one ring are
+    // passed without comparing each element against the other rings.
+    // If fn throws, the elements it already accepted are removed and the exception propagates.
+    template <typename Fn>
+    size_t consume(Fn&& fn, size_t max_count = std::numeric_limits<size_t>::max());
+
+    // Re-reads the front of ring `index` after it was pushed to or popped
+    // from directly. O(N). Throws std::out_of_range if index >= ring_count().
+    void refresh(size_t index);
+
+    // Re-reads the front of every ring. O(N).
+    void refresh();
+
+    // Checks whether every ring is empty.
+    bool empty() const;
+
+    // Returns the number of elements left in all rings.
+    size_t size() const;
+
+    // Returns the number of rings being merged.
+    size_t ring_count() const;
+
+private:
+    struct Leaf {
+        Timestamp timestamp{};
+        bool live = false;  // False once the ring is empty
+    };
+
+    // Whether ring a's front comes out before ring b's.
+    bool before(size_t a, size_t b) const;
+
+    // Number of elements at the front of ring `index`, up to limit, that come
+    // out before every other ring's front.
+    size_t run_length(size_t index, size_t limit) const;
+
+    void load(size_t index);
+    void replay(size_t index);
+    void build();
+
+    std::vector<RingBuffer<T>*> rings_;
+    TimestampOf timestamp_of_;
+    std::vector<Leaf> leaves_;    // Front timestamp of every ring
+    std::vector<size_t> losers_;  // losers_[0] is the winner; losers_[node] lost the match at node
+};
+
+template <typename T, typename TimestampOf>
+MergedRingReader<T, TimestampOf>::MergedRingReader(std::vector<RingBuffer<T>*> rings, TimestampOf timestamp_of)
+    : rings_(std::move(rings)), timestamp_of_(std::move(timestamp_of)) {
+    if (rings_.empty()) {
+        throw std::invalid_argument("MergedRingReader needs at least one ring.");
+    }
+    for (const RingBuffer<T>* ring : rings_) {
+        if (ring == nullptr) {
+            throw std::invalid_argument("MergedRingReader rings must not be null.");
+        }
+    }
+    leaves_.resize(rings_.size());
+    losers_.resize(rings_.size());
+    refresh();
+}
+
+template <typename T, typename TimestampOf>
+const T& MergedRingReader<T, TimestampOf>::front() const {
+    return rings_[front_ring()]->front();
+}
+
+template <typename T, typename TimestampOf>
+size_t MergedRingReader<T, TimestampOf>::front_ring() const {
+    if (empty()) {
+        throw std::out_of_range("MergedRingReader is empty");
+    }
+    return losers_[0];
+}
+
+template <typename T, typename TimestampOf>
+T MergedRingReader<T, TimestampOf>::pop() {
+    const size_t index = front_ring();
+    T item = rings_[index]->pop();
+    load(index);
+    replay(index);
+    return item;
+}
+
+template <typename T, typename TimestampOf>
+bool MergedRingReader<T, TimestampOf>::try_pop(T& out_item) {
+    if (empty()) {
+        return false;
+    }
+    const size_t index = losers_[0];
+    rings_[index]->try_pop(out_item);
+    load(index);
+    replay(index);
+    return true;
+}
+
+template <typename T, typename TimestampOf>
+template <typename Fn>
+size_t MergedRingReader<T, TimestampOf>::consume(Fn&& fn, size_t max_count) {
+    size_t removed = 0;
+    size_t previous = rings_.size();
+    while (removed < max_count && !empty()) {
+        // Look for a run only once a ring wins twice in a row, so closely
+        // interleaved rings cost no more than pop().
+        const size_t index = losers_[0];
+        const size_t run = index == previous ? run_length(index, max_count - removed) : 1;
+        previous = index;
+        try {
+            removed += rings_[index]->consume(fn, run);
+        } catch (...) {
+            load(index);
+            replay(index);
+            throw;
+        }
+        load(index);
+        replay(index);
+    }
+    return removed;
+}
+
+template <typename T, typename TimestampOf>
+void MergedRingReader<T, TimestampOf>::refresh(size_t index) {
+    if (index >= rings_.size()) {
+        throw std::out_of_range("Index out of bounds for MergedRingReader::refresh()");
+    }
+    // A front that moves earlier can beat rings it already lost to, which a
+    // replay along its own path would not see, so rebuild.
+    load(index);
+    build();
+}
+
+template <typename T, typename TimestampOf>
+void MergedRingReader<T, TimestampOf>::refresh() {
+    for (size_t i = 0; i < rings_.size(); ++i) {
+        load(i);
+    }
+    build();
+}
+
+template <typename T, typename TimestampOf>
+bool MergedRingReader<T, TimestampOf>::empty() const {
+    return !leaves_[losers_[0]].live;
+}
+
+template <typename T, typename TimestampOf>
+size_t MergedRingReader<T, TimestampOf>::size() const {
+    size_t total = 0;
+    for (const RingBuffer<T>* ring : rings_) {
+        total += ring->size();
+    }
+    return total;
+}
+
+template <typename T, typename TimestampOf>
+size_t MergedRingReader<T, TimestampOf>::ring_count() const {
+    return rings_.size();
+}
+
+template <typename T, typename TimestampOf>
+bool MergedRingReader<T, TimestampOf>::before(size_t a, size_t b) const {
+    const Leaf& x = leaves_[a];
+    const Leaf& y = leaves_[b];
+    if (!x.live || !y.live) {
+        return x.live;
+    }
+    if (x.timestamp < y.timestamp) {
+        return true;
+    }
+    if (y.timestamp < x.timestamp) {
+        return false;
+    }
+    return a < b;
+}
+
+template <typename T, typename TimestampOf>
+size_t MergedRingReader<T, TimestampOf>::run_length(size_t index, size_t limit) const {
+    // The runner-up is the best of the rings the winner beat on its way up.
+    const size_t n = rings_.size();
+    size_t runner = index;
+    for (size_t node = (index + n) >> 1; node > 0; node >>= 1) {
+        if (runner == index || before(losers_[node], runner)) {
+            runner = losers_[node];
+        }
+    }
+    const RingBuffer<T>& ring = *rings_[index];
+    if (runner == index || !leaves_[runner].live) {
+        return std::min(ring.size(), limit);
+    }
+
+    const Timestamp& bound = leaves_[runner].timestamp;
+    size_t count = 0;
+    const auto [first, second] = ring.segments();
+    for (const std::span<const T> part : {first, second}) {
+        for (const T& item : part) {
+            if (count == limit) {
+                return count;
+            }
+            const auto& timestamp = std::invoke(timestamp_of_, item);
+            if (bound < timestamp || (!(timestamp < bound) && runner < index)) {
+                return count;
+            }
+            ++count;
+        }
+    }
+    return count;
+}
+
+template <typename T, typename TimestampOf>
+void MergedRingReader<T, TimestampOf>::load(size_t index) {
+    const RingBuffer<T>& ring = *rings_[index];
+    leaves_[index].live = !ring.empty();
+    if (leaves_[index].live) {
+        leaves_[index].timestamp = std::invoke(timestamp_of_, ring.front());
+    }
+}
+
+template <typename T, typename TimestampOf>
+void MergedRingReader<T, TimestampOf>::replay(size_t index) {
+    // Only valid for the previous winner: every match on its path holds the
+    // ring it beat there.
+    size_t winner = index;
+    for (size_t node = (index + rings_.size()) >> 1; node > 0; node >>= 1) {
+        if (before(losers_[node], winner)) {
+            std::swap(losers_[node], winner);
+        }
+    }
+    losers_[0] = winner;
+}
+
+template <typename T, typename TimestampOf>
+void MergedRingReader<T, TimestampOf>::build() {
+    // Rings are the leaves n to 2n - 1 of an implicit binary tree; node i plays
+    // the winners of nodes 2i and 2i + 1.
+    const size_t n = rings_.size();
+    std::vector<size_t> winners(2 * n);
+    for (size_t i = 0; i < n; ++i) {
+        winners[n + i] = i;
+    }
+    for (size_t node = n - 1; node > 0; --node) {
+        const size_t left = winners[2 * node];
+        const size_t right = winners[2 * node + 1];
+        const bool left_wins = before(left, right);
+        winners[node] = left_wins ? left : right;
+        losers_[node] = left_wins ? right : left;
+    }
+    losers_[0] = n == 1 ? 0 : winners[1];
+}
+
+#endif // RING_BUFFER_MERGE_HPP
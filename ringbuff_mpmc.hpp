@@ -0,0 +1,313 @@
+#ifndef RING_BUFFER_MPMC_HPP
+#define RING_BUFFER_MPMC_HPP
+
+#include <atomic>       // For std::atomic
+#include <cstddef>      // For size_t
+#include <memory>       // For std::unique_ptr
+#include <iterator>     // For std::iter_reference_t
+#include <new>          // For placement new
+#include <span>         // For std::span
+#include <stdexcept>    // For std::invalid_argument
+#include <type_traits>  // For std::is_nothrow_constructible_v
+#include <utility>      // For std::forward, std::move
+
+#include "ringbuff_memory_order.hpp"
+
+// A bounded lock-free multi-producer/multi-consumer ring buffer.
+// Each slot carries a sequence number that tells producers when the slot is
+// free for their lap and consumers when it holds data for theirs, so threads
+// only contend on the head/tail counters and on the slot they claimed.
+// Unlike RingBuffer, a full buffer rejects new elements instead of overwriting.
+// T's move operations must not throw, since a claimed slot is always published.
+template <typename T>
+class MpmcRingBuffer {
+    static_assert(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>,
+                  "MpmcRingBuffer requires nothrow move operations");
+
+public:
+    // Constructs a buffer holding at least `capacity` elements.
+    // The capacity is rounded up to a power of two; capacity() reports the result.
+    // Throws std::invalid_argument if capacity is 0.
+    explicit MpmcRingBuffer(size_t capacity);
+
+    // Destroys any elements still in the buffer.
+    ~MpmcRingBuffer();
+
+    MpmcRingBuffer(const MpmcRingBuffer&) = delete;
+    MpmcRingBuffer& operator=(const MpmcRingBuffer&) = delete;
+
+    // Attempts to add an element to the back of the buffer (copy version).
+    // Returns true if successful, false if the buffer is full.
+    bool try_push(const T& item);
+
+    // Attempts to add an element to the back of the buffer (move version).
+    // Returns true if successful, false if the buffer is full.
+    bool try_push(T&& item);
+
+    // Attempts to construct an element in-place at the back of the buffer.
+    // Returns true if successful, false if the buffer is full.
+    template <typename... Args>
+    bool try_emplace(Args&&... args);
+
+    // Attempts to remove the oldest element and move it into out_item.
+    // Returns true if successful, false if the buffer is empty. Also returns
+    // false while the producer of the oldest slot is still writing it, even if
+    // later pushes have already completed, so an empty result is not linearizable.
+    bool try_pop(T& out_item);
+
+    // Attempts to add up to `count` elements constructed from first, first + 1, ...
+    // Claims every free slot it can with a single compare-and-swap on the tail,
+    // so a burst costs one contended operation instead of one per element.
+    // Returns the number of elements added, which is less than count when the
+    // buffer fills up and 0 when it is full. Pass std::make_move_iterator to move.
+    template <typename InputIt>
+    size_t try_push_bulk(InputIt first, size_t count);
+
+    // Attempts to remove up to out.size() of the oldest elements into out, in order.
+    // Claims every ready slot it can with a single compare-and-swap on the head.
+    // Returns the number of elements removed, 0 if the buffer is empty.
+    size_t try_pop_bulk(std::span<T> out);
+
+    // Returns the number of elements at some recent instant.
+    // Only a hint while other threads are pushing or popping.
+    size_t size() const;
+
+    // Checks if the buffer looked empty at some recent instant.
+    bool empty() const;
+
+    // Returns the maximum number of elements the buffer can hold.
+    size_t capacity() const;
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;                  // Position this cell expects next
+        alignas(T) unsigned char storage[sizeof(T)];   // Raw storage for one element
+    };
+
+    static constexpr size_t cache_line = 64;
+
+    // Constructs the element, staging it first if construction may throw.
+    template <typename... Args>
+    bool enqueue(Args&&... args);
+
+    // Claims the next free cell, constructs the element there and publishes it.
+    template <typename... Args>
+    bool claim_and_construct(Args&&... args);
+
+    static size_t round_up_pow2(size_t value);
+
+    size_t capacity_;                                  // Number of cells, a power of two
+    size_t mask_;                                      // capacity_ - 1
+    std::unique_ptr<Cell[]> cells_;                    // The underlying storage for elements
+    alignas(cache_line) std::atomic<size_t> tail_{0};  // Next position to be written
+    alignas(cache_line) std::atomic<size_t> head_{0};  // Next position to be read
+};
+
+template <typename T>
+MpmcRingBuffer<T>::MpmcRingBuffer(size_t capacity) {
+    if (capacity == 0) {
+        throw std::invalid_argument("MpmcRingBuffer capacity must be greater than 0.");
+    }
+    capacity_ = round_up_pow2(capacity);
+    mask_ = capacity_ - 1;
+    cells_.reset(new Cell[capacity_]);
+    for (size_t i = 0; i < capacity_; ++i) {
+        cells_[i].sequence.store(i, ring_order::relaxed);
+    }
+}
+
+template <typename T>
+MpmcRingBuffer<T>::~MpmcRingBuffer() {
+    size_t head = head_.load(ring_order::relaxed);
+    const size_t tail = tail_.load(ring_order::relaxed);
+    for (; head != tail; ++head) {
+        std::launder(reinterpret_cast<T*>(cells_[head & mask_].storage))->~T();
+    }
+}
+
+template <typename T>
+bool MpmcRingBuffer<T>::try_push(const T& item) {
+    return enqueue(item);
+}
+
+template <typename T>
+bool MpmcRingBuffer<T>::try_push(T&& item) {
+    return enqueue(std::move(item));
+}
+
+template <typename T>
+template <typename... Args>
+bool MpmcRingBuffer<T>::try_emplace(Args&&... args) {
+    return enqueue(std::forward<Args>(args)...);
+}
+
+template <typename T>
+template <typename... Args>
+bool MpmcRingBuffer<T>::enqueue(Args&&... args) {
+    // A claimed cell must always be published, so a throwing constructor runs
+    // before the claim and the element is then moved into place.
+    if constexpr (!std::is_nothrow_constructible_v<T, Args&&...>) {
+        T staged(std::forward<Args>(args)...);
+        return claim_and_construct(std::move(staged));
+    } else {
+        return claim_and_construct(std::forward<Args>(args)...);
+    }
+}
+
+template <typename T>
+template <typename... Args>
+bool MpmcRingBuffer<T>::claim_and_construct(Args&&... args) {
+    size_t pos = tail_.load(ring_order::relaxed);
+    Cell* cell;
+    for (;;) {
+        cell = &cells_[pos & mask_];
+        const size_t seq = cell->sequence.load(ring_order::acquire);
+        const auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+        if (diff == 0) {
+            if (tail_.compare_exchange_weak(pos, pos + 1, ring_order::relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = tail_.load(ring_order::relaxed);
+        }
+    }
+    new (cell->storage) T(std::forward<Args>(args)...);
+    cell->sequence.store(pos + 1, ring_order::release);
+    return true;
+}
+
+template <typename T>
+bool MpmcRingBuffer<T>::try_pop(T& out_item) {
+    size_t pos = head_.load(ring_order::relaxed);
+    Cell* cell;
+    for (;;) {
+        cell = &cells_[pos & mask_];
+        const size_t seq = cell->sequence.load(ring_order::acquire);
+        const auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+        if (diff == 0) {
+            if (head_.compare_exchange_weak(pos, pos + 1, ring_order::relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = head_.load(ring_order::relaxed);
+        }
+    }
+    T* item = std::launder(reinterpret_cast<T*>(cell->storage));
+    out_item = std::move(*item);
+    item->~T();
+    cell->sequence.store(pos + capacity_, ring_order::release);
+    return true;
+}
+
+template <typename T>
+template <typename InputIt>
+size_t MpmcRingBuffer<T>::try_push_bulk(InputIt first, size_t count) {
+    static_assert(std::is_nothrow_constructible_v<T, std::iter_reference_t<InputIt>>,
+                  "MpmcRingBuffer::try_push_bulk requires constructing T from the iterator not to throw");
+    if (count == 0) {
+        return 0;
+    }
+    size_t pos = tail_.load(ring_order::relaxed);
+    size_t claimed;
+    for (;;) {
+        const size_t seq = cells_[pos & mask_].sequence.load(ring_order::acquire);
+        const auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+        if (diff < 0) {
+            return 0;
+        }
+        if (diff > 0) {
+            pos = tail_.load(ring_order::relaxed);
+            continue;
+        }
+        // Only the producer of a position moves its cell past it, so cells
+        // seen free here stay free until the tail is moved over them.
+        claimed = 1;
+        while (claimed < count && cells_[(pos + claimed) & mask_].sequence.load(ring_order::acquire) == pos + claimed) {
+            ++claimed;
+        }
+        if (tail_.compare_exchange_weak(pos, pos + claimed, ring_order::relaxed)) {
+            break;
+        }
+    }
+    for (size_t i = 0; i < claimed; ++i, ++first) {
+        Cell& cell = cells_[(pos + i) & mask_];
+        new (cell.storage) T(*first);
+        cell.sequence.store(pos + i + 1, ring_order::release);
+    }
+    return claimed;
+}
+
+template <typename T>
+size_t MpmcRingBuffer<T>::try_pop_bulk(std::span<T> out) {
+    if (out.empty()) {
+        return 0;
+    }
+    size_t pos = head_.load(ring_order::relaxed);
+    size_t claimed;
+    for (;;) {
+        const size_t seq = cells_[pos & mask_].sequence.load(ring_order::acquire);
+        const auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+        if (diff < 0) {
+            return 0;
+        }
+        if (diff > 0) {
+            pos = head_.load(ring_order::relaxed);
+            continue;
+        }
+        claimed = 1;
+        while (claimed < out.size() &&
+               cells_[(pos + claimed) & mask_].sequence.load(ring_order::acquire) == pos + claimed + 1) {
+            ++claimed;
+        }
+        if (head_.compare_exchange_weak(pos, pos + claimed, ring_order::relaxed)) {
+            break;
+        }
+    }
+    for (size_t i = 0; i < claimed; ++i) {
+        Cell& cell = cells_[(pos + i) & mask_];
+        T* item = std::launder(reinterpret_cast<T*>(cell.storage));
+        out[i] = std::move(*item);
+        item->~T();
+        cell.sequence.store(pos + i + capacity_, ring_order::release);
+    }
+    return claimed;
+}
+
+template <typename T>
+size_t MpmcRingBuffer<T>::size() const {
+    const size_t head = head_.load(ring_order::relaxed);
+    const size_t tail = tail_.load(ring_order::relaxed);
+    const auto diff = static_cast<std::ptrdiff_t>(tail - head);
+    if (diff <= 0) {
+        return 0;
+    }
+    return static_cast<size_t>(diff) > capacity_ ? capacity_ : static_cast<size_t>(diff);
+}
+
+template <typename T>
+bool MpmcRingBuffer<T>::empty() const {
+    return size() == 0;
+}
+
+template <typename T>
+size_t MpmcRingBuffer<T>::capacity() const {
+    return capacity_;
+}
+
+template <typename T>
+size_t MpmcRingBuffer<T>::round_up_pow2(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        if (result > (static_cast<size_t>(-1) >> 1)) {
+            throw std::invalid_argument("MpmcRingBuffer capacity is too large.");
+        }
+        result <<= 1;
+    }
+    return result;
+}
+
+#endif // RING_BUFFER_MPMC_HPP
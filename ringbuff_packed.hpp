@@ -0,0 +1,406 @@
+#ifndef RING_BUFFER_PACKED_HPP
+#define RING_BUFFER_PACKED_HPP
+
+#include <algorithm>  // For std::min
+#include <array>      // For std::array
+#include <bit>        // For std::popcount
+#include <cstddef>    // For size_t
+#include <cstdint>    // For uint8_t, uint64_t
+#include <stdexcept>  // For std::invalid_argument, std::out_of_range
+#include <vector>     // For std::vector
+
+#include "ringbuff.hpp"
+
+// A fixed-size ring of small unsigned values packed Bits to a value,
+// 64 / Bits values per 64-bit word. Like RingBuffer, pushing into a full
+// buffer overwrites the oldest value. The ring keeps a count of each of the
+// 2^Bits possible values, so count() over the whole window is O(1) and
+// needs no pass over the storage.
+// Suited to pass/fail flags (Bits = 1) and small enums (Bits = 2 or 4).
+template <unsigned Bits>
+class PackedRingBuffer {
+    static_assert(Bits == 1 || Bits == 2 || Bits == 4, "PackedRingBuffer supports 1, 2 and 4 bit values");
+
+public:
+    static constexpr uint8_t max_value = (1u << Bits) - 1;  // Largest value that fits
+
+    // Constructs a buffer holding `capacity` values.
+    // Throws std::invalid_argument if capacity is 0.
+    explicit PackedRingBuffer(size_t capacity);
+
+    // Adds a value to the back of the buffer.
+    // If the buffer is full, the oldest value is overwritten.
+    // Throws std::invalid_argument if value is greater than max_value.
+    void push(uint8_t value);
+
+    // Adds a value to the back of the buffer if it is not full.
+    // Returns true if successful, false if the buffer is full.
+    bool try_push(uint8_t value);
+
+    // Removes and returns the oldest value.
+    // Throws std::out_of_range if the buffer is empty.
+    uint8_t pop();
+
+    // Removes the oldest value and stores it in out_value.
+    // Returns true if successful, false if the buffer is empty.
+    bool try_pop(uint8_t& out_value);
+
+    // Returns the oldest value. Throws std::out_of_range if the buffer is empty.
+    uint8_t front() const;
+
+    // Returns the value at a logical index (0 is the oldest).
+    // Throws std::out_of_range if index >= size().
+    uint8_t at(size_t index) const;
+
+    // Returns how many values in the buffer equal `value`, in O(1).
+    // Returns 0 if value is greater than max_value.
+    size_t count(uint8_t value) const;
+
+    // Removes the `count` oldest values. With 1 or 2 bits, the counts are
+    // updated a word at a time, 64 / Bits values per step.
+    // Throws std::out_of_range if count > size().
+    void discard(size_t count);
+
+    // Removes all values.
+    void clear();
+
+    // Checks if the buffer is empty.
+    bool empty() const;
+
+    // Checks if the buffer is full.
+    bool full() const;
+
+    // Returns the number of values in the buffer.
+    size_t size() const;
+
+    // Returns the maximum number of values the buffer can hold.
+    size_t capacity() const;
+
+private:
+    static constexpr size_t values_per_word = 64 / Bits;
+    static constexpr uint64_t value_mask = max_value;
+
+    uint8_t get(size_t slot) const;
+    void set(size_t slot, uint8_t value);
+    size_t next(size_t slot) const;
+    void uncount(size_t first, size_t count);
+
+    std::vector<uint64_t> words_;               // The packed storage
+    size_t capacity_;                           // The maximum number of values the buffer can hold
+    size_t head_ = 0;                           // Slot of the oldest value
+    size_t tail_ = 0;                           // Slot the next value is written to
+    size_t size_ = 0;                           // Current number of values
+    std::array<size_t, max_value + 1> counts_{};  // Occurrences of each value in the buffer
+};
+
+// RingBuffer<bool> stores 64 flags per word and keeps a running count of
+// true flags, so the error rate of a sliding window of pass/fail flags is
+// count() / size() in O(1). Elements are returned by value, so there is no
+// front() reference, iteration or segments() access.
+// ringbuff.hpp declares this specialization and includes this header.
+template <>
+class RingBuffer<bool> {
+public:
+    // Constructs a buffer holding `capacity` flags.
+    // Throws std::invalid_argument if capacity is 0.
+    explicit RingBuffer(size_t capacity);
+
+    // Adds a flag to the back of the buffer, overwriting the oldest when full.
+    void push(bool flag);
+
+    // Adds a flag to the back of the buffer if it is not full.
+    // Returns true if successful, false if the buffer is full.
+    bool try_push(bool flag);
+
+    // Removes and returns the oldest flag.
+    // Throws std::out_of_range if the buffer is empty.
+    bool pop();
+
+    // Removes the oldest flag and stores it in out_flag.
+    // Returns true if successful, false if the buffer is empty.
+    bool try_pop(bool& out_flag);
+
+    // Returns the oldest flag. Throws std::out_of_range if the buffer is empty.
+    bool front() const;
+
+    // Returns the flag at a logical index (0 is the oldest).
+    // Throws std::out_of_range if index >= size().
+    bool at(size_t index) const;
+
+    // Returns the number of true flags in the buffer, in O(1).
+    size_t count() const;
+
+    // Removes the `count` oldest flags, with one popcount per 64 flags.
+    // Throws std::out_of_range if count > size().
+    void discard(size_t count);
+
+    // Removes all flags.
+    void clear();
+
+    // Checks if the buffer is empty.
+    bool empty() const;
+
+    // Checks if the buffer is full.
+    bool full() const;
+
+    // Returns the number of flags in the buffer.
+    size_t size() const;
+
+    // Returns the maximum number of flags the buffer can hold.
+    size_t capacity() const;
+
+private:
+    static size_t checked_capacity(size_t capacity);
+
+    PackedRingBuffer<1> bits_;  // The packed flags and their running count
+};
+
+template <unsigned Bits>
+PackedRingBuffer<Bits>::PackedRingBuffer(size_t capacity) : capacity_(capacity) {
+    if (capacity == 0) {
+        throw std::invalid_argument("PackedRingBuffer capacity must be greater than 0.");
+    }
+    words_.resize(capacity / values_per_word + 1);
+}
+
+template <unsigned Bits>
+void PackedRingBuffer<Bits>::push(uint8_t value) {
+    if (value > max_value) {
+        throw std::invalid_argument("Value does not fit in a PackedRingBuffer element.");
+    }
+    if (size_ == capacity_) {
+        --counts_[get(tail_)];
+        head_ = next(head_);
+    } else {
+        ++size_;
+    }
+    set(tail_, value);
+    ++counts_[value];
+    tail_ = next(tail_);
+}
+
+template <unsigned Bits>
+bool PackedRingBuffer<Bits>::try_push(uint8_t value) {
+    if (full()) {
+        return false;
+    }
+    push(value);
+    return true;
+}
+
+template <unsigned Bits>
+uint8_t PackedRingBuffer<Bits>::pop() {
+    if (empty()) {
+        throw std::out_of_range("Cannot pop from an empty PackedRingBuffer.");
+    }
+    const uint8_t value = get(head_);
+    --counts_[value];
+    head_ = next(head_);
+    --size_;
+    return value;
+}
+
+template <unsigned Bits>
+bool PackedRingBuffer<Bits>::try_pop(uint8_t& out_value) {
+    if (empty()) {
+        return false;
+    }
+    out_value = pop();
+    return true;
+}
+
+template <unsigned Bits>
+uint8_t PackedRingBuffer<Bits>::front() const {
+    if (empty()) {
+        throw std::out_of_range("Cannot get front from an empty PackedRingBuffer.");
+    }
+    return get(head_);
+}
+
+template <unsigned Bits>
+uint8_t PackedRingBuffer<Bits>::at(size_t index) const {
+    if (index >= size_) {
+        throw std::out_of_range("Index out of bounds for PackedRingBuffer::at()");
+    }
+    const size_t slot = index < capacity_ - head_ ? head_ + index : index - (capacity_ - head_);
+    return get(slot);
+}
+
+template <unsigned Bits>
+size_t PackedRingBuffer<Bits>::count(uint8_t value) const {
+    return value > max_value ? 0 : counts_[value];
+}
+
+template <unsigned Bits>
+void PackedRingBuffer<Bits>::discard(size_t count) {
+    if (count > size_) {
+        throw std::out_of_range("Cannot discard more values than the PackedRingBuffer holds.");
+    }
+    const size_t first = std::min(count, capacity_ - head_);
+    uncount(head_, first);
+    uncount(0, count - first);
+    head_ = (head_ + count) % capacity_;
+    size_ -= count;
+}
+
+template <unsigned Bits>
+void PackedRingBuffer<Bits>::clear() {
+    head_ = 0;
+    tail_ = 0;
+    size_ = 0;
+    counts_.fill(0);
+}
+
+template <unsigned Bits>
+bool PackedRingBuffer<Bits>::empty() const {
+    return size_ == 0;
+}
+
+template <unsigned Bits>
+bool PackedRingBuffer<Bits>::full() const {
+    return size_ == capacity_;
+}
+
+template <unsigned Bits>
+size_t PackedRingBuffer<Bits>::size() const {
+    return size_;
+}
+
+template <unsigned Bits>
+size_t PackedRingBuffer<Bits>::capacity() const {
+    return capacity_;
+}
+
+template <unsigned Bits>
+uint8_t PackedRingBuffer<Bits>::get(size_t slot) const {
+    const unsigned shift = static_cast<unsigned>(slot % values_per_word) * Bits;
+    return static_cast<uint8_t>((words_[slot / values_per_word] >> shift) & value_mask);
+}
+
+template <unsigned Bits>
+void PackedRingBuffer<Bits>::set(size_t slot, uint8_t value) {
+    const unsigned shift = static_cast<unsigned>(slot % values_per_word) * Bits;
+    uint64_t& word = words_[slot / values_per_word];
+    word = (word & ~(value_mask << shift)) | (static_cast<uint64_t>(value) << shift);
+}
+
+template <unsigned Bits>
+size_t PackedRingBuffer<Bits>::next(size_t slot) const {
+    return slot + 1 == capacity_ ? 0 : slot + 1;
+}
+
+// Takes the values in slots [first, first + count) out of counts_. In each
+// word, the lanes equal to a value are those where word ^ (value in every
+// lane) is zero; OR-folding each lane into its lowest bit and masking leaves
+// one bit per match for popcount. With Bits == 1 that is one popcount per word.
+template <unsigned Bits>
+void PackedRingBuffer<Bits>::uncount(size_t first, size_t count) {
+    const size_t end = first + count;
+    if constexpr (Bits == 4) {
+        // Fifteen masks per 16-value word cost more than reading each value.
+        for (size_t slot = first; slot < end; ++slot) {
+            --counts_[get(slot)];
+        }
+        return;
+    }
+    constexpr uint64_t lane_lows = ~uint64_t{0} / value_mask;  // Lowest bit of every lane
+    for (size_t slot = first; slot < end;) {
+        const size_t low = slot % values_per_word;
+        const size_t high = std::min(values_per_word, low + (end - slot));
+        const uint64_t in_range = (high == values_per_word ? ~uint64_t{0} : (uint64_t{1} << (high * Bits)) - 1) &
+                                  ~((uint64_t{1} << (low * Bits)) - 1);
+        const uint64_t word = words_[slot / values_per_word];
+        size_t nonzero = 0;
+        for (unsigned value = 1; value <= max_value; ++value) {
+            uint64_t differs = word ^ (lane_lows * value);
+            for (unsigned shift = 1; shift < Bits; shift <<= 1) {
+                differs |= differs >> shift;
+            }
+            const size_t matches = static_cast<size_t>(std::popcount(~differs & lane_lows & in_range));
+            counts_[value] -= matches;
+            nonzero += matches;
+        }
+        counts_[0] -= high - low - nonzero;
+        slot += high - low;
+    }
+}
+
+inline size_t RingBuffer<bool>::checked_capacity(size_t capacity) {
+    if (capacity == 0) {
+        throw std::invalid_argument("RingBuffer capacity must be greater than 0.");
+    }
+    return capacity;
+}
+
+inline RingBuffer<bool>::RingBuffer(size_t capacity) : bits_(checked_capacity(capacity)) {}
+
+inline void RingBuffer<bool>::push(bool flag) {
+    bits_.push(flag);
+}
+
+inline bool RingBuffer<bool>::try_push(bool flag) {
+    return bits_.try_push(flag);
+}
+
+inline bool RingBuffer<bool>::pop() {
+    if (bits_.empty()) {
+        throw std::out_of_range("Cannot pop from an empty RingBuffer.");
+    }
+    return bits_.pop() != 0;
+}
+
+inline bool RingBuffer<bool>::try_pop(bool& out_flag) {
+    uint8_t value = 0;
+    if (!bits_.try_pop(value)) {
+        return false;
+    }
+    out_flag = value != 0;
+    return true;
+}
+
+inline bool RingBuffer<bool>::front() const {
+    if (bits_.empty()) {
+        throw std::out_of_range("Cannot get front from an empty RingBuffer.");
+    }
+    return bits_.front() != 0;
+}
+
+inline bool RingBuffer<bool>::at(size_t index) const {
+    if (index >= bits_.size()) {
+        throw std::out_of_range("Index out of bounds for RingBuffer::at() const");
+    }
+    return bits_.at(index) != 0;
+}
+
+inline size_t RingBuffer<bool>::count() const {
+    return bits_.count(1);
+}
+
+inline void RingBuffer<bool>::discard(size_t count) {
+    if (count > bits_.size()) {
+        throw std::out_of_range("Cannot discard more elements than the RingBuffer holds.");
+    }
+    bits_.discard(count);
+}
+
+inline void RingBuffer<bool>::clear() {
+    bits_.clear();
+}
+
+inline bool RingBuffer<bool>::empty() const {
+    return bits_.empty();
+}
+
+inline bool RingBuffer<bool>::full() const {
+    return bits_.full();
+}
+
+inline size_t RingBuffer<bool>::size() const {
+    return bits_.size();
+}
+
+inline size_t RingBuffer<bool>::capacity() const {
+    return bits_.capacity();
+}
+
+#endif // RING_BUFFER_PACKED_HPP
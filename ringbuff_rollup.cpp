@@ -0,0 +1,143 @@
+#include "ringbuff_rollup.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+void RollupBucket::add(double value) {
+    ++count;
+    sum += value;
+    min = std::min(min, value);
+    max = std::max(max, value);
+}
+
+void RollupBucket::merge(const RollupBucket& other) {
+    count += other.count;
+    sum += other.sum;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+}
+
+double RollupBucket::mean() const {
+    return count == 0 ? std::numeric_limits<double>::quiet_NaN() : sum / static_cast<double>(count);
+}
+
+MultiResolutionRing::MultiResolutionRing(std::vector<Resolution> levels) : resolutions_(std::move(levels)) {
+    if (resolutions_.empty()) {
+        throw std::invalid_argument("MultiResolutionRing needs at least one level.");
+    }
+    for (size_t i = 0; i < resolutions_.size(); ++i) {
+        const Resolution& level = resolutions_[i];
+        if (level.period == 0 || level.buckets == 0) {
+            throw std::invalid_argument("MultiResolutionRing periods and bucket counts must be greater than 0.");
+        }
+        if (i > 0 && level.period % resolutions_[i - 1].period != 0) {
+            throw std::invalid_argument("Each MultiResolutionRing period must be a multiple of the previous one.");
+        }
+        closed_.emplace_back(level.buckets);
+    }
+    open_.resize(resolutions_.size());
+}
+
+void MultiResolutionRing::push(uint64_t timestamp, double value) {
+    RollupBucket sample;
+    sample.start = timestamp;
+    sample.add(value);
+    feed(0, sample);
+}
+
+void MultiResolutionRing::feed(size_t level, const RollupBucket& part) {
+    const uint64_t start = part.start - part.start % resolutions_[level].period;
+    RollupBucket& open = open_[level];
+    if (open.count != 0 && start > open.start) {
+        closed_[level].push(open);
+        if (level + 1 < open_.size()) {
+            feed(level + 1, open);
+        }
+        open = RollupBucket{};
+    }
+    if (open.count == 0) {
+        open.start = start;
+    }
+    open.merge(part);
+}
+
+RollupBucket MultiResolutionRing::query(size_t level, uint64_t from, uint64_t to) const {
+    check_level(level);
+    RollupBucket result;
+    result.start = from;
+    if (from >= to) {
+        return result;
+    }
+
+    // Closed buckets are in start order: binary search for the first one in range.
+    const RingBuffer<RollupBucket>& ring = closed_[level];
+    size_t low = 0;
+    size_t high = ring.size();
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        if (ring.at(mid).start < from) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    for (size_t i = low; i < ring.size() && ring.at(i).start < to; ++i) {
+        result.merge(ring.at(i));
+    }
+
+    // Open buckets of this and finer levels hold samples this level has not closed yet.
+    for (size_t i = 0; i <= level; ++i) {
+        if (open_[i].count != 0 && open_[i].start >= from && open_[i].start < to) {
+            result.merge(open_[i]);
+        }
+    }
+    return result;
+}
+
+RollupBucket MultiResolutionRing::query(uint64_t from, uint64_t to) const {
+    return query(level_for(from), from, to);
+}
+
+size_t MultiResolutionRing::level_for(uint64_t timestamp) const {
+    for (size_t level = 0; level < closed_.size(); ++level) {
+        const RingBuffer<RollupBucket>& ring = closed_[level];
+        if (!ring.full() || ring.front().start <= timestamp) {
+            return level;
+        }
+    }
+    return closed_.size() - 1;
+}
+
+const RingBuffer<RollupBucket>& MultiResolutionRing::buckets(size_t level) const {
+    check_level(level);
+    return closed_[level];
+}
+
+const RollupBucket& MultiResolutionRing::open_bucket(size_t level) const {
+    check_level(level);
+    return open_[level];
+}
+
+size_t MultiResolutionRing::levels() const {
+    return resolutions_.size();
+}
+
+const Resolution& MultiResolutionRing::resolution(size_t level) const {
+    check_level(level);
+    return resolutions_[level];
+}
+
+size_t MultiResolutionRing::memory_bytes() const {
+    size_t buckets = 0;
+    for (const Resolution& level : resolutions_) {
+        buckets += level.buckets + 1;
+    }
+    return buckets * sizeof(RollupBucket);
+}
+
+void MultiResolutionRing::check_level(size_t level) const {
+    if (level >= resolutions_.size()) {
+        throw std::out_of_range("Level out of bounds for MultiResolutionRing.");
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef RING_BUFFER_ROLLUP_HPP
+#define RING_BUFFER_ROLLUP_HPP
+
+#include <cstddef>  // For size_t
+#include <cstdint>  // For uint64_t
+#include <limits>   // For std::numeric_limits
+#include <vector>   // For std::vector
+
+#include "ringbuff.hpp"
+
+// Aggregate of the samples in one time bucket.
+struct RollupBucket {
+    uint64_t start = 0;                                      // First timestamp the bucket covers
+    uint64_t count = 0;
+    double sum = 0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    // Adds one sample.
+    void add(double value);
+
+    // Adds every sample of another bucket.
+    void merge(const RollupBucket& other);
+
+    // Returns sum / count, or NaN for an empty bucket.
+    double mean() const;
+};
+
+// One level of a MultiResolutionRing: `buckets` buckets of `period` time units each.
+struct Resolution {
+    uint64_t period;
+    size_t buckets;
+};
+
+// Round-robin storage of a metric at several resolutions, as in RRDtool.
+// Samples land in an open bucket of the finest level. When a sample falls in
+// a later period, the open bucket is closed: it is pushed onto that level's
+// RingBuffer and merged into the open bucket of the next coarser level, which
+// closes the same way. Each level's ring overwrites its oldest bucket when
+// full, so memory is fixed at construction and a sample costs O(1) amortized.
+// Periods with no samples take no space. Timestamps are in any unit, as long
+// as they match the periods, and should not decrease; a late sample is folded
+// into the open bucket.
+class MultiResolutionRing {
+public:
+    // Constructs the levels, finest first.
+    // Throws std::invalid_argument if there are no levels, a period or bucket
+    // count is 0, or a period is not a multiple of the previous one.
+    explicit MultiResolutionRing(std::vector<Resolution> levels);
+
+    // Adds a sample taken at `timestamp`.
+    void push(uint64_t timestamp, double value);
+
+    // Aggregates the samples with timestamps in [from, to) using one level.
+    // Buckets count if their start is in the range, so the range is rounded to
+    // the level's period. Samples not yet cascaded to the level are included.
+    // Throws std::out_of_range if level >= levels().
+    RollupBucket query(size_t level, uint64_t from, uint64_t to) const;
+
+    // Same as query(level, from, to), using the finest level that still holds `from`.
+    RollupBucket query(uint64_t from, uint64_t to) const;
+
+    // Returns the finest level whose closed buckets reach back to `timestamp`,
+    // or the coarsest level if none does.
+    size_t level_for(uint64_t timestamp) const;
+
+    // Returns the closed buckets of a level, oldest first.
+    // Throws std::out_of_range if level >= levels().
+    const RingBuffer<RollupBucket>& buckets(size_t level) const;
+
+    // Returns the bucket of a level still receiving samples.
+    // Throws std::out_of_range if level >= levels().
+    const RollupBucket& open_bucket(size_t level) const;
+
+    // Returns the number of levels.
+    size_t levels() const;
+
+    // Returns the period and bucket count of a level.
+    // Throws std::out_of_range if level >= levels().
+    const Resolution& resolution(size_t level) const;
+
+    // Returns the bytes of bucket storage across all levels.
+    size_t memory_bytes() const;
+
+private:
+    // Merges `part` into the open bucket of `level`, closing that bucket first
+    // if `part` starts in a later period.
+    void feed(size_t level, const RollupBucket& part);
+    void check_level(size_t level) const;
+
+    std::vector<Resolution> resolutions_;
+    std::vector<RingBuffer<RollupBucket>> closed_;  // One ring per level
+    std::vector<RollupBucket> open_;                // One open bucket per level
+};
+
+#endif // RING_BUFFER_ROLLUP_HPP
@@ -0,0 +1,124 @@
+#ifndef RING_BUFFER_SORT_HPP
+#define RING_BUFFER_SORT_HPP
+
+#include <algorithm>    // For std::sort, std::nth_element, std::copy
+#include <bit>          // For std::bit_cast
+#include <cstddef>      // For size_t
+#include <cstdint>      // For uint32_t, uint64_t
+#include <span>         // For std::span
+#include <type_traits>  // For std::is_integral_v, std::make_unsigned_t
+#include <utility>      // For std::swap
+#include <vector>       // For std::vector
+
+// Sorting used by RingBuffer::sort(), sorted_copy() and nth_element_copy().
+// Integers, floats and doubles are ordered through an unsigned key with the
+// same order and sorted with an LSD radix sort on 11-bit digits, skipping
+// digits that every element shares. Floating-point values follow the IEEE
+// total order: -0.0 before 0.0, and NaNs at the ends by sign. Other types
+// use std::sort with operator<.
+namespace ring_sort {
+
+template <typename T>
+inline constexpr bool radix_sortable = (std::is_integral_v<T> && !std::is_same_v<T, bool>) ||
+                                       std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+// Below this many elements the radix passes cost more than they save.
+inline constexpr size_t radix_threshold = 512;
+
+// Maps a value to an unsigned integer of the same width and order.
+template <typename T>
+auto radix_key(T value) {
+    if constexpr (std::is_integral_v<T>) {
+        using Key = std::make_unsigned_t<T>;
+        constexpr Key sign = std::is_signed_v<T> ? Key(Key{1} << (8 * sizeof(T) - 1)) : Key{0};
+        return Key(static_cast<Key>(value) ^ sign);
+    } else {
+        using Key = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+        const Key bits = std::bit_cast<Key>(value);
+        // Negative values have every bit flipped, positive ones just the sign
+        // bit. Computed without a branch, which random signs would mispredict.
+        constexpr Key sign = Key{1} << (8 * sizeof(T) - 1);
+        return Key(bits ^ (Key(0 - (bits >> (8 * sizeof(T) - 1))) | sign));
+    }
+}
+
+// The order sort() produces, for std::sort and std::nth_element.
+template <typename T>
+bool less(const T& a, const T& b) {
+    if constexpr (radix_sortable<T>) {
+        return radix_key(a) < radix_key(b);
+    } else {
+        return a < b;
+    }
+}
+
+// Radix digits of 11 bits: three passes for 32-bit keys and six for 64-bit
+// ones, with each pass's 2048 counters still fitting in L1.
+inline constexpr unsigned radix_bits = 11;
+inline constexpr size_t radix_buckets = size_t{1} << radix_bits;
+
+// Sorts values with scratch, at least values.size() elements, as the second buffer.
+template <typename T>
+void radix_sort(std::span<T> values, std::span<T> scratch) {
+    const size_t n = values.size();
+    if (n == 0) {
+        return;
+    }
+    constexpr size_t digits = (8 * sizeof(T) + radix_bits - 1) / radix_bits;
+    using Key = decltype(radix_key(T{}));
+    // One histogram per digit, all filled in a single read of the input.
+    std::vector<size_t> counts(digits * radix_buckets);
+    for (const T value : values) {
+        const Key key = radix_key(value);
+        for (size_t digit = 0; digit < digits; ++digit) {
+            ++counts[digit * radix_buckets + ((key >> (radix_bits * digit)) & (radix_buckets - 1))];
+        }
+    }
+
+    T* from = values.data();
+    T* to = scratch.data();
+    for (size_t digit = 0; digit < digits; ++digit) {
+        size_t* offsets = counts.data() + digit * radix_buckets;
+        const unsigned shift = radix_bits * static_cast<unsigned>(digit);
+        if (offsets[(radix_key(from[0]) >> shift) & (radix_buckets - 1)] == n) {
+            continue;
+        }
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < radix_buckets; ++bucket) {
+            const size_t count = offsets[bucket];
+            offsets[bucket] = offset;
+            offset += count;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            to[offsets[(radix_key(from[i]) >> shift) & (radix_buckets - 1)]++] = from[i];
+        }
+        std::swap(from, to);
+    }
+    if (from != values.data()) {
+        std::copy(from, from + n, values.data());
+    }
+}
+
+// Sorts values in the order of less().
+template <typename T>
+void sort(std::span<T> values) {
+    if constexpr (radix_sortable<T>) {
+        if (values.size() >= radix_threshold) {
+            std::vector<T> scratch(values.size());
+            radix_sort(values, std::span<T>(scratch));
+            return;
+        }
+    }
+    std::sort(values.begin(), values.end(), [](const T& a, const T& b) { return ring_sort::less(a, b); });
+}
+
+// Partially sorts values so that values[k] is the element sort() would put there.
+template <typename T>
+void nth_element(std::span<T> values, size_t k) {
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(k), values.end(),
+                     [](const T& a, const T& b) { return ring_sort::less(a, b); });
+}
+
+}  // namespace ring_sort
+
+#endif // RING_BUFFER_SORT_HPP
@@ -0,0 +1,154 @@
+#include "ringbuff_spectrum.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+#include <utility>
+
+RingFft::RingFft(size_t size, SpectrumWindow window) : size_(size) {
+    if (size < 2 || (size & (size - 1)) != 0 || size > (size_t{1} << 31)) {
+        throw std::invalid_argument("RingFft size must be a power of two of at least 2.");
+    }
+    const double step = -2.0 * std::numbers::pi / static_cast<double>(size);
+    twiddles_.resize(size / 2);
+    for (size_t k = 0; k < size / 2; ++k) {
+        twiddles_[k] = std::complex<float>(std::polar(1.0, step * static_cast<double>(k)));
+    }
+
+    unsigned bits = 0;
+    while ((size_t{1} << bits) < size) {
+        ++bits;
+    }
+    reversed_.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+        reversed_[i] = static_cast<uint32_t>(reversed_[i >> 1] >> 1 | (i & 1) << (bits - 1));
+    }
+
+    if (window == SpectrumWindow::Hann) {
+        weights_.resize(size);
+        for (size_t i = 0; i < size; ++i) {
+            weights_[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * std::numbers::pi * static_cast<double>(i) /
+                                                                  static_cast<double>(size)));
+        }
+    }
+    bins_.resize(size);
+    power_.resize(size / 2 + 1);
+}
+
+std::span<const std::complex<float>> RingFft::transform(std::span<const float> first, std::span<const float> second) {
+    if (first.size() + second.size() < size_) {
+        throw std::out_of_range("RingFft needs at least size() samples.");
+    }
+    // Skip the oldest samples so the newest size_ remain, then gather in bit-reversed order.
+    const size_t skip = first.size() + second.size() - size_;
+    const std::span<const float> head = first.subspan(std::min(skip, first.size()));
+    const std::span<const float> tail = second.subspan(skip > first.size() ? skip - first.size() : 0);
+    size_t i = 0;
+    for (const std::span<const float> part : {head, tail}) {
+        for (const float sample : part) {
+            const float weighted = weights_.empty() ? sample : sample * weights_[i];
+            bins_[reversed_[i]] = std::complex<float>(weighted, 0.0f);
+            ++i;
+        }
+    }
+
+    // Iterative decimation-in-time butterflies, on the interleaved (real, imaginary)
+    // floats that std::complex guarantees, which keeps the compiler from
+    // round-tripping values through the stack.
+    float* data = reinterpret_cast<float*>(bins_.data());
+    const float* twiddles = reinterpret_cast<const float*>(twiddles_.data());
+    for (size_t half = 1, stride = size_ / 2; half < size_; half <<= 1, stride >>= 1) {
+        for (size_t block = 0; block < size_; block += 2 * half) {
+            float* a = data + 2 * block;
+            float* b = a + 2 * half;
+            for (size_t j = 0; j < half; ++j) {
+                const float w_re = twiddles[2 * j * stride];
+                const float w_im = twiddles[2 * j * stride + 1];
+                const float b_re = b[2 * j];
+                const float b_im = b[2 * j + 1];
+                const float t_re = w_re * b_re - w_im * b_im;
+                const float t_im = w_re * b_im + w_im * b_re;
+                b[2 * j] = a[2 * j] - t_re;
+                b[2 * j + 1] = a[2 * j + 1] - t_im;
+                a[2 * j] += t_re;
+                a[2 * j + 1] += t_im;
+            }
+        }
+    }
+    return bins_;
+}
+
+std::span<const float> RingFft::power_spectrum(std::span<const float> first, std::span<const float> second) {
+    transform(first, second);
+    for (size_t k = 0; k < power_.size(); ++k) {
+        power_[k] = std::norm(bins_[k]);
+    }
+    return power_;
+}
+
+size_t RingFft::size() const {
+    return size_;
+}
+
+SlidingDft::SlidingDft(size_t size, std::vector<size_t> bins)
+    : bins_(std::move(bins)), window_(size == 0 ? 1 : size) {
+    if (size == 0) {
+        throw std::invalid_argument("SlidingDft size must be greater than 0.");
+    }
+    for (const size_t bin : bins_) {
+        if (bin >= size) {
+            throw std::invalid_argument("SlidingDft bins must be below the window size.");
+        }
+        rotations_.push_back(std::polar(1.0, 2.0 * std::numbers::pi * static_cast<double>(bin) / static_cast<double>(size)));
+    }
+    values_.assign(bins_.size(), 0.0);
+    for (size_t i = 0; i < size; ++i) {
+        window_.push(0.0f);
+    }
+}
+
+void SlidingDft::push(float sample) {
+    const double delta = static_cast<double>(sample) - static_cast<double>(window_.front());
+    window_.push(sample);
+    for (size_t i = 0; i < values_.size(); ++i) {
+        values_[i] = (values_[i] + delta) * rotations_[i];
+    }
+    if (++since_resync_ == 16 * window_.capacity()) {
+        resync();
+    }
+}
+
+std::complex<double> SlidingDft::value(size_t index) const {
+    if (index >= values_.size()) {
+        throw std::out_of_range("Index out of bounds for SlidingDft::value()");
+    }
+    return values_[index];
+}
+
+double SlidingDft::magnitude(size_t index) const {
+    return std::abs(value(index));
+}
+
+const std::vector<size_t>& SlidingDft::bins() const {
+    return bins_;
+}
+
+size_t SlidingDft::size() const {
+    return window_.capacity();
+}
+
+void SlidingDft::resync() {
+    const double step = -2.0 * std::numbers::pi / static_cast<double>(window_.capacity());
+    for (size_t i = 0; i < bins_.size(); ++i) {
+        std::complex<double> sum = 0.0;
+        size_t m = 0;
+        for (const float sample : window_) {
+            sum += static_cast<double>(sample) *
+                   std::polar(1.0, step * static_cast<double>((bins_[i] * m) % window_.capacity()));
+            ++m;
+        }
+        values_[i] = sum;
+    }
+    since_resync_ = 0;
+}
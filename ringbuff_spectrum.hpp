@@ -0,0 +1,107 @@
+#ifndef RING_BUFFER_SPECTRUM_HPP
+#define RING_BUFFER_SPECTRUM_HPP
+
+#include <complex>  // For std::complex
+#include <cstddef>  // For size_t
+#include <cstdint>  // For uint32_t, uint64_t
+#include <span>     // For std::span
+#include <vector>   // For std::vector
+
+#include "ringbuff.hpp"
+
+// Weighting applied to the samples before a transform.
+enum class SpectrumWindow {
+    Rectangular,  // No weighting
+    Hann,         // Raised cosine, lower spectral leakage
+};
+
+// A radix-2 FFT over the newest size() samples of a float ring.
+// Twiddle factors, the bit-reversal permutation and the window weights are
+// computed once at construction. transform() reads the samples straight from
+// the ring's two segments into bit-reversed order, so nothing is copied out
+// first, and runs the butterflies in place in a buffer owned by the object.
+// Call it every few milliseconds for overlapping windows.
+class RingFft {
+public:
+    // Constructs a transform of `size` samples.
+    // Throws std::invalid_argument if size is not a power of two of at least 2.
+    explicit RingFft(size_t size, SpectrumWindow window = SpectrumWindow::Hann);
+
+    // Transforms the newest size() samples of the concatenation first + second,
+    // as returned by RingBuffer<float>::segments(). Returns size() complex bins,
+    // valid until the next call. Throws std::out_of_range if fewer samples are given.
+    std::span<const std::complex<float>> transform(std::span<const float> first, std::span<const float> second = {});
+
+    // Same as transform(first, second) with the segments of a ring.
+    std::span<const std::complex<float>> transform(const RingBuffer<float>& ring);
+
+    // Transforms like transform(first, second) and returns the squared
+    // magnitudes of bins 0 to size() / 2, valid until the next call.
+    std::span<const float> power_spectrum(std::span<const float> first, std::span<const float> second = {});
+
+    // Same as power_spectrum(first, second) with the segments of a ring.
+    std::span<const float> power_spectrum(const RingBuffer<float>& ring);
+
+    // Returns the number of samples per transform.
+    size_t size() const;
+
+private:
+    size_t size_;
+    std::vector<std::complex<float>> twiddles_;  // exp(-2 pi i k / size) for k < size / 2
+    std::vector<uint32_t> reversed_;             // Bit-reversed index of every position
+    std::vector<float> weights_;                 // Window weights, empty for Rectangular
+    std::vector<std::complex<float>> bins_;
+    std::vector<float> power_;
+};
+
+// Tracks selected DFT bins of the newest `size` samples, one sample at a time.
+// Each push updates every tracked bin in O(1) with the sliding DFT recurrence
+// X_k <- (X_k - oldest + newest) * exp(2 pi i k / size), so tracking B bins
+// costs O(B) per sample instead of a transform per sample. The bins match a
+// rectangular-window transform of the same samples. Rounding error that the
+// recurrence accumulates is cleared by recomputing the bins exactly every
+// 16 * size pushes. Samples before the first push count as 0.
+class SlidingDft {
+public:
+    // Constructs a tracker of the given bins of a size-sample window.
+    // Throws std::invalid_argument if size is 0 or a bin is not below size.
+    SlidingDft(size_t size, std::vector<size_t> bins);
+
+    // Adds a sample and updates every tracked bin.
+    void push(float sample);
+
+    // Returns the current value of the index-th tracked bin.
+    // Throws std::out_of_range if index is not below bins().size().
+    std::complex<double> value(size_t index) const;
+
+    // Returns the magnitude of the index-th tracked bin.
+    // Throws std::out_of_range if index is not below bins().size().
+    double magnitude(size_t index) const;
+
+    // Returns the tracked bin numbers.
+    const std::vector<size_t>& bins() const;
+
+    // Returns the window length.
+    size_t size() const;
+
+private:
+    void resync();
+
+    std::vector<size_t> bins_;
+    std::vector<std::complex<double>> rotations_;  // exp(2 pi i k / size) per tracked bin
+    std::vector<std::complex<double>> values_;
+    RingBuffer<float> window_;                     // The newest size samples, always full
+    uint64_t since_resync_ = 0;
+};
+
+inline std::span<const std::complex<float>> RingFft::transform(const RingBuffer<float>& ring) {
+    const auto [first, second] = ring.segments();
+    return transform(first, second);
+}
+
+inline std::span<const float> RingFft::power_spectrum(const RingBuffer<float>& ring) {
+    const auto [first, second] = ring.segments();
+    return power_spectrum(first, second);
+}
+
+#endif // RING_BUFFER_SPECTRUM_HPP
@@ -0,0 +1,114 @@
+#include "ringbuff_stress.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+namespace {
+
+// Push and pop of one value. Values still in the queue pop "at infinity".
+struct Lifetime {
+    uint64_t value;
+    const HistoryOp* push = nullptr;
+    const HistoryOp* pop = nullptr;
+
+    uint64_t pop_invoke() const {
+        return pop != nullptr ? pop->invoke : std::numeric_limits<uint64_t>::max();
+    }
+};
+
+std::string describe(const char* what, uint64_t value) {
+    return std::string(what) + " (value " + std::to_string(value) + ")";
+}
+
+}  // namespace
+
+bool StressReport::ok() const {
+    return lost == 0 && duplicated == 0 && reordered == 0 && corrupt == 0 && violation.empty();
+}
+
+std::string check_queue_history(const std::vector<HistoryOp>& history) {
+    std::unordered_map<uint64_t, Lifetime> lifetimes;
+    std::vector<const HistoryOp*> empties;
+    for (const HistoryOp& op : history) {
+        if (op.kind == HistoryOp::PopEmpty) {
+            empties.push_back(&op);
+            continue;
+        }
+        Lifetime& lifetime = lifetimes.try_emplace(op.value, Lifetime{op.value}).first->second;
+        const HistoryOp*& slot = op.kind == HistoryOp::Push ? lifetime.push : lifetime.pop;
+        if (slot != nullptr) {
+            return describe(op.kind == HistoryOp::Push ? "value pushed twice" : "value popped twice", op.value);
+        }
+        slot = &op;
+    }
+
+    std::vector<const Lifetime*> by_push_response;
+    for (const auto& [value, lifetime] : lifetimes) {
+        if (lifetime.push == nullptr) {
+            return describe("popped a value that was never pushed", value);
+        }
+        if (lifetime.pop != nullptr && lifetime.pop->response < lifetime.push->invoke) {
+            return describe("pop completed before the push started", value);
+        }
+        by_push_response.push_back(&lifetime);
+    }
+    std::sort(by_push_response.begin(), by_push_response.end(),
+              [](const Lifetime* a, const Lifetime* b) { return a->push->response < b->push->response; });
+
+    // Both remaining checks ask, for an operation starting at time t, which value
+    // pushed before t is popped last; a sweep keeps that maximum as t grows.
+    auto sweep = [&](std::vector<std::pair<uint64_t, const void*>> probes,
+                     auto&& check) -> std::string {
+        std::sort(probes.begin(), probes.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+        size_t next = 0;
+        const Lifetime* latest = nullptr;
+        for (const auto& [start, probe] : probes) {
+            while (next < by_push_response.size() && by_push_response[next]->push->response < start) {
+                if (latest == nullptr || by_push_response[next]->pop_invoke() > latest->pop_invoke()) {
+                    latest = by_push_response[next];
+                }
+                ++next;
+            }
+            if (latest != nullptr) {
+                std::string violation = check(probe, *latest);
+                if (!violation.empty()) {
+                    return violation;
+                }
+            }
+        }
+        return {};
+    };
+
+    // FIFO order: if push(a) finished before push(b) started, pop(b) must not
+    // finish before pop(a) starts.
+    std::vector<std::pair<uint64_t, const void*>> popped;
+    for (const Lifetime* lifetime : by_push_response) {
+        if (lifetime->pop != nullptr) {
+            popped.emplace_back(lifetime->push->invoke, lifetime);
+        }
+    }
+    std::string violation = sweep(popped, [](const void* probe, const Lifetime& a) {
+        const Lifetime& b = *static_cast<const Lifetime*>(probe);
+        if (b.pop->response >= a.pop_invoke()) {
+            return std::string();
+        }
+        return a.pop == nullptr ? describe("value never popped although a later one was", a.value)
+                                : describe("values popped in the opposite order of their pushes", b.value);
+    });
+    if (!violation.empty()) {
+        return violation;
+    }
+
+    // Empty pops: no value may have been in the queue for the whole call.
+    std::vector<std::pair<uint64_t, const void*>> empty_probes;
+    for (const HistoryOp* op : empties) {
+        empty_probes.emplace_back(op->invoke, op);
+    }
+    return sweep(empty_probes, [](const void* probe, const Lifetime& a) {
+        const HistoryOp& empty = *static_cast<const HistoryOp*>(probe);
+        return empty.response < a.pop_invoke() ? describe("pop reported empty while a value was queued", a.value)
+                                               : std::string();
+    });
+}
@@ -0,0 +1,329 @@
+#ifndef RING_BUFFER_STRESS_HPP
+#define RING_BUFFER_STRESS_HPP
+
+#include <algorithm>  // For std::min
+#include <atomic>     // For std::atomic
+#include <chrono>     // For std::chrono::steady_clock, std::chrono::milliseconds
+#include <concepts>   // For std::convertible_to
+#include <cstddef>    // For size_t
+#include <cstdint>    // For uint8_t, uint64_t
+#include <memory>     // For std::unique_ptr
+#include <random>     // For std::mt19937_64
+#include <span>       // For std::span
+#include <stdexcept>  // For std::invalid_argument
+#include <string>     // For std::string
+#include <thread>     // For std::thread, std::this_thread::yield
+#include <vector>     // For std::vector
+
+#include "ringbuff_affinity.hpp"
+
+// Settings for run_stress().
+struct StressOptions {
+    size_t producers = 4;
+    size_t consumers = 4;
+    uint64_t items_per_producer = 100000;   // Items each producer pushes per round
+    std::chrono::milliseconds soak{0};      // Keep running rounds until this much time has passed
+    double yield_probability = 0.01;        // Chance of yielding before each operation
+    uint64_t seed = 1;                      // Seeds the per-thread yield decisions
+    std::vector<int> cpus;                  // Pin threads round-robin to these CPUs if not empty
+    bool record_history = false;            // Record every operation and check linearizability
+    size_t bulk_min = 0;                    // If bulk_max is not 0, move random batches of
+    size_t bulk_max = 0;                    // bulk_min..bulk_max with try_push_bulk/try_pop_bulk
+};
+
+// Outcome of run_stress().
+struct StressReport {
+    uint64_t rounds = 0;
+    uint64_t pushed = 0;
+    uint64_t popped = 0;
+    uint64_t lost = 0;             // Pushed but never popped
+    uint64_t duplicated = 0;       // Popped more than once
+    uint64_t reordered = 0;        // Popped out of order relative to an earlier pop of the same producer
+    uint64_t corrupt = 0;          // Popped a value no producer pushed
+    uint64_t history_ops = 0;      // Operations checked for linearizability
+    std::string violation;         // First linearizability violation found, empty if none
+    double seconds = 0;
+    double ops_per_second = 0;     // Pushes and pops per second, including checking overhead
+
+    // Checks whether no anomaly was found.
+    bool ok() const;
+};
+
+// One completed operation in a recorded history. Timestamps come from a
+// shared logical clock, so a.response < b.invoke means a finished before b started.
+struct HistoryOp {
+    enum Kind : uint8_t { Push, Pop, PopEmpty };
+
+    Kind kind;
+    uint64_t value;     // Pushed or popped value, unused for PopEmpty
+    uint64_t invoke;    // Clock reading before the call
+    uint64_t response;  // Clock reading after the call
+};
+
+// Checks a FIFO queue history in which every value is pushed at most once.
+// Looks for the patterns that make such a history non-linearizable: a pop of a
+// value never pushed or popped twice, a pop finishing before its push started,
+// two values popped in the opposite order of their non-overlapping pushes, and
+// an empty pop while some value was certainly in the queue.
+// Runs in O(n log n). Returns a description of the first violation, or an empty string.
+std::string check_queue_history(const std::vector<HistoryOp>& history);
+
+// Hammers a concurrent queue with producers and consumers and checks the outcome.
+// Producers push unique stamped values (producer id and sequence number), and
+// consumers verify each pop: no value is lost, duplicated or invented, and the
+// values of each producer reach every consumer in push order. With
+// record_history, every operation is also logged and checked with
+// check_queue_history(). Queue needs try_push(uint64_t) and try_pop(uint64_t&),
+// as MpmcRingBuffer, TaggedRingBuffer and UnboundedRing provide; it must be
+// empty on entry. With bulk_max set, producers and consumers move batches
+// through try_push_bulk(const uint64_t*, size_t) and try_pop_bulk(std::span<uint64_t>)
+// instead, as MpmcRingBuffer provides; a partial batch is retried from where it
+// stopped. Build with -fsanitize=thread to have data races reported too.
+// Throws std::invalid_argument for unusable options.
+template <typename Queue>
+StressReport run_stress(Queue& queue, const StressOptions& options = {});
+
+namespace stress_detail {
+
+constexpr unsigned sequence_bits = 40;
+constexpr uint64_t sequence_mask = (uint64_t{1} << sequence_bits) - 1;
+
+template <typename Queue>
+concept BulkQueue = requires(Queue& queue, const uint64_t* values, std::span<uint64_t> out) {
+    { queue.try_push_bulk(values, size_t{1}) } -> std::convertible_to<size_t>;
+    { queue.try_pop_bulk(out) } -> std::convertible_to<size_t>;
+};
+
+struct Round {
+    std::atomic<uint64_t> clock{0};               // Logical clock for history timestamps
+    std::atomic<size_t> producers_left{0};
+    std::atomic<bool> go{false};
+    std::vector<std::unique_ptr<std::atomic<uint64_t>[]>> seen;  // Per-producer bitmap of popped sequences
+    std::vector<std::vector<HistoryOp>> logs;     // One per thread
+    std::vector<StressReport> tallies;            // One per consumer
+};
+
+class Yielder {
+public:
+    Yielder(const StressOptions& options, uint64_t round, size_t thread)
+        : rng_(options.seed ^ (round * 0x9E3779B97F4A7C15ull) ^ (thread * 0xBF58476D1CE4E5B9ull)),
+          threshold_(static_cast<uint64_t>(options.yield_probability * 18446744073709551615.0)) {}
+
+    void maybe_yield() {
+        if (threshold_ != 0 && rng_() < threshold_) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Returns the size of the next batch: 1, or random in bulk_min..bulk_max.
+    size_t batch(const StressOptions& options) {
+        return options.bulk_max == 0 ? 1 : options.bulk_min + rng_() % (options.bulk_max - options.bulk_min + 1);
+    }
+
+private:
+    std::mt19937_64 rng_;
+    uint64_t threshold_;
+};
+
+inline void start_thread(const StressOptions& options, size_t thread, Round& round) {
+    if (!options.cpus.empty()) {
+        pin_current_thread(options.cpus[thread % options.cpus.size()]);
+    }
+    while (!round.go.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+template <typename Queue>
+void produce(Queue& queue, const StressOptions& options, uint64_t round_index, size_t producer, Round& round) {
+    start_thread(options, producer, round);
+    Yielder yielder(options, round_index, producer);
+    std::vector<HistoryOp>& log = round.logs[producer];
+    std::vector<uint64_t> values;
+    for (uint64_t sequence = 0; sequence < options.items_per_producer;) {
+        const size_t count = std::min<uint64_t>(yielder.batch(options), options.items_per_producer - sequence);
+        values.clear();
+        for (size_t i = 0; i < count; ++i) {
+            values.push_back((static_cast<uint64_t>(producer + 1) << sequence_bits) | (sequence + i));
+        }
+        for (size_t done = 0; done < count;) {
+            yielder.maybe_yield();
+            const uint64_t invoke = options.record_history ? round.clock.fetch_add(1) : 0;
+            size_t pushed = 0;
+            if constexpr (BulkQueue<Queue>) {
+                if (options.bulk_max != 0) {
+                    pushed = queue.try_push_bulk(values.data() + done, count - done);
+                }
+            }
+            if (options.bulk_max == 0) {
+                pushed = queue.try_push(values[done]) ? 1 : 0;
+            }
+            if (pushed == 0) {
+                std::this_thread::yield();
+                continue;
+            }
+            if (options.record_history) {
+                const uint64_t response = round.clock.fetch_add(1);
+                for (size_t i = done; i < done + pushed; ++i) {
+                    log.push_back(HistoryOp{HistoryOp::Push, values[i], invoke, response});
+                }
+            }
+            done += pushed;
+        }
+        sequence += count;
+    }
+    round.producers_left.fetch_sub(1, std::memory_order_release);
+}
+
+// Tallies one popped value: invented, duplicated, or out of its producer's order.
+inline void check_pop(uint64_t value, const StressOptions& options, Round& round, StressReport& tally,
+                      std::vector<uint64_t>& next_expected) {
+    const uint64_t producer = (value >> sequence_bits) - 1;
+    const uint64_t sequence = value & sequence_mask;
+    if ((value >> sequence_bits) == 0 || producer >= options.producers || sequence >= options.items_per_producer) {
+        ++tally.corrupt;
+        return;
+    }
+    ++tally.popped;
+    const uint64_t bit = uint64_t{1} << (sequence % 64);
+    if ((round.seen[producer][sequence / 64].fetch_or(bit, std::memory_order_relaxed) & bit) != 0) {
+        ++tally.duplicated;
+    } else if (sequence < next_expected[producer]) {
+        ++tally.reordered;
+    }
+    if (sequence >= next_expected[producer]) {
+        next_expected[producer] = sequence + 1;
+    }
+}
+
+template <typename Queue>
+void consume(Queue& queue, const StressOptions& options, uint64_t round_index, size_t consumer, Round& round) {
+    const size_t thread = options.producers + consumer;
+    start_thread(options, thread, round);
+    Yielder yielder(options, round_index, thread);
+    std::vector<HistoryOp>& log = round.logs[thread];
+    StressReport& tally = round.tallies[consumer];
+    std::vector<uint64_t> next_expected(options.producers, 0);  // Lowest sequence not yet seen, per producer
+    std::vector<uint64_t> values(options.bulk_max == 0 ? 1 : options.bulk_max);
+    bool in_empty_run = false;
+
+    for (;;) {
+        yielder.maybe_yield();
+        // Read before the attempt: a failed pop after every producer finished means the queue is drained.
+        const bool drained = round.producers_left.load(std::memory_order_acquire) == 0;
+        const uint64_t invoke = options.record_history ? round.clock.fetch_add(1) : 0;
+        size_t popped = 0;
+        if constexpr (BulkQueue<Queue>) {
+            if (options.bulk_max != 0) {
+                popped = queue.try_pop_bulk(std::span<uint64_t>(values).first(yielder.batch(options)));
+            }
+        }
+        if (options.bulk_max == 0) {
+            popped = queue.try_pop(values[0]) ? 1 : 0;
+        }
+        if (popped == 0) {
+            if (options.record_history && !in_empty_run) {
+                log.push_back(HistoryOp{HistoryOp::PopEmpty, 0, invoke, round.clock.fetch_add(1)});
+            }
+            in_empty_run = true;
+            if (drained) {
+                return;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+        const uint64_t response = options.record_history ? round.clock.fetch_add(1) : 0;
+        in_empty_run = false;
+        for (size_t i = 0; i < popped; ++i) {
+            if (options.record_history) {
+                log.push_back(HistoryOp{HistoryOp::Pop, values[i], invoke, response});
+            }
+            check_pop(values[i], options, round, tally, next_expected);
+        }
+    }
+}
+
+template <typename Queue>
+void run_round(Queue& queue, const StressOptions& options, uint64_t round_index, StressReport& report) {
+    Round round;
+    const size_t words = (options.items_per_producer + 63) / 64;
+    for (size_t p = 0; p < options.producers; ++p) {
+        round.seen.emplace_back(new std::atomic<uint64_t>[words]);
+        for (size_t w = 0; w < words; ++w) {
+            round.seen.back()[w].store(0, std::memory_order_relaxed);
+        }
+    }
+    round.logs.resize(options.producers + options.consumers);
+    round.tallies.resize(options.consumers);
+    round.producers_left.store(options.producers, std::memory_order_relaxed);
+
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < options.producers; ++p) {
+        threads.emplace_back([&, p] { produce(queue, options, round_index, p, round); });
+    }
+    for (size_t c = 0; c < options.consumers; ++c) {
+        threads.emplace_back([&, c] { consume(queue, options, round_index, c, round); });
+    }
+    round.go.store(true, std::memory_order_release);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    const uint64_t pushed = options.producers * options.items_per_producer;
+    uint64_t distinct = 0;
+    for (size_t p = 0; p < options.producers; ++p) {
+        for (size_t w = 0; w < words; ++w) {
+            distinct += static_cast<uint64_t>(__builtin_popcountll(round.seen[p][w].load(std::memory_order_relaxed)));
+        }
+    }
+    report.pushed += pushed;
+    report.lost += pushed - distinct;
+    for (const StressReport& tally : round.tallies) {
+        report.popped += tally.popped;
+        report.duplicated += tally.duplicated;
+        report.reordered += tally.reordered;
+        report.corrupt += tally.corrupt;
+    }
+
+    if (options.record_history) {
+        std::vector<HistoryOp> history;
+        for (const std::vector<HistoryOp>& log : round.logs) {
+            history.insert(history.end(), log.begin(), log.end());
+        }
+        report.history_ops += history.size();
+        if (report.violation.empty()) {
+            report.violation = check_queue_history(history);
+        }
+    }
+}
+
+}  // namespace stress_detail
+
+template <typename Queue>
+StressReport run_stress(Queue& queue, const StressOptions& options) {
+    if (options.producers == 0 || options.consumers == 0) {
+        throw std::invalid_argument("Stress runs need at least one producer and one consumer.");
+    }
+    if (options.items_per_producer == 0 || options.items_per_producer > stress_detail::sequence_mask ||
+        options.producers >= (uint64_t{1} << (64 - stress_detail::sequence_bits)) - 1) {
+        throw std::invalid_argument("Stress run sizes are out of range.");
+    }
+    if (options.bulk_max != 0 && (options.bulk_min == 0 || options.bulk_min > options.bulk_max)) {
+        throw std::invalid_argument("Stress batches need 0 < bulk_min <= bulk_max.");
+    }
+    if (options.bulk_max != 0 && !stress_detail::BulkQueue<Queue>) {
+        throw std::invalid_argument("Bulk stress runs need try_push_bulk and try_pop_bulk.");
+    }
+
+    StressReport report;
+    const auto start = std::chrono::steady_clock::now();
+    do {
+        stress_detail::run_round(queue, options, report.rounds++, report);
+    } while (report.ok() && std::chrono::steady_clock::now() - start < options.soak);
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report.ops_per_second = report.seconds > 0 ? static_cast<double>(report.pushed + report.popped) / report.seconds : 0;
+    return report;
+}
+
+#endif // RING_BUFFER_STRESS_HPP
@@ -0,0 +1,355 @@
+#ifndef RING_BUFFER_TAGGED_HPP
+#define RING_BUFFER_TAGGED_HPP
+
+#include <atomic>       // For std::atomic
+#include <cstddef>      // For size_t
+#include <cstdint>      // For uint64_t
+#include <cstring>      // For std::memcpy
+#include <memory>       // For std::unique_ptr
+#include <stdexcept>    // For std::invalid_argument
+#include <type_traits>  // For std::conditional_t, std::is_trivially_copyable_v
+
+#include "ringbuff_memory_order.hpp"
+
+#if !defined(__SIZEOF_INT128__)
+#error "TaggedRingBuffer requires compiler support for 128-bit integers"
+#endif
+
+// A bounded lock-free multi-producer/multi-consumer ring of tagged 128-bit slots.
+// Every slot is a single (payload, tag) pair updated with one double-width
+// compare-and-swap (cmpxchg16b on x86-64), so publishing an element and its
+// ABA tag is a single atomic step and no separate sequence array is touched.
+// The tag encodes the lap of the ring the slot belongs to and whether it is
+// full, which makes a stale producer's or consumer's CAS fail instead of
+// landing in a later lap.
+//
+// The ring owns the upper 64 bits of every slot for its tag, so the single-CAS
+// slot holds a trivially copyable T of at most 8 bytes (a pointer, an index, a
+// handle). A 16-byte T, such as a (pointer, tag) pair, gets a 32-byte slot with
+// a separate 64-bit tag word that is claimed by CAS and then published by a
+// release store, the same protocol MpmcRingBuffer uses; like it, a producer
+// stalled between claim and publish holds up consumers of that slot.
+// Neither layout moves fewer bytes per element than MpmcRingBuffer: its cell
+// is a sequence word next to the payload too. What the 8-byte layout buys is
+// a slot that is published by the CAS itself. Compare with bench_mpmc_rings.
+//
+// The CMake build adds -mcx16 on x86-64 so the CAS is inlined, and links
+// libatomic where the compiler cannot inline it.
+template <typename T>
+class TaggedRingBuffer {
+    static_assert(std::is_trivially_copyable_v<T>, "TaggedRingBuffer requires a trivially copyable T");
+    static_assert(sizeof(T) <= 2 * sizeof(uint64_t), "TaggedRingBuffer payloads must fit in 128 bits");
+
+public:
+    // Constructs a buffer holding at least `capacity` elements.
+    // The capacity is rounded up to a power of two; capacity() reports the result.
+    // Throws std::invalid_argument if capacity is 0.
+    explicit TaggedRingBuffer(size_t capacity);
+
+    TaggedRingBuffer(const TaggedRingBuffer&) = delete;
+    TaggedRingBuffer& operator=(const TaggedRingBuffer&) = delete;
+
+    // Attempts to add an element to the back of the buffer.
+    // Returns true if successful, false if the buffer is full.
+    bool try_push(const T& item);
+
+    // Attempts to remove the oldest element and copy it into out_item.
+    // Returns true if successful, false if the buffer is empty. For 16-byte T
+    // also returns false while the producer of the oldest slot is still writing it.
+    bool try_pop(T& out_item);
+
+    // Returns the number of elements at some recent instant.
+    // Only a hint while other threads are pushing or popping.
+    size_t size() const;
+
+    // Checks if the buffer looked empty at some recent instant.
+    bool empty() const;
+
+    // Returns the maximum number of elements the buffer can hold.
+    size_t capacity() const;
+
+private:
+    using Word = unsigned __int128;
+
+    // Whether T shares one 128-bit word with its tag.
+    static constexpr bool packed = sizeof(T) <= sizeof(uint64_t);
+
+    // One slot for T of at most 8 bytes: the payload in the low half, the tag
+    // in the high half. Tag 2 * lap means empty for that lap, 2 * lap + 1 full.
+    struct alignas(16) PackedSlot {
+        Word word;
+    };
+
+    // One slot for larger T. Tag 4 * lap means empty for that lap, + 1 being
+    // written, + 2 full and + 3 being read.
+    struct alignas(32) SplitSlot {
+        std::atomic<uint64_t> tag{0};
+        alignas(16) unsigned char storage[sizeof(T)];
+    };
+
+    using Slot = std::conditional_t<packed, PackedSlot, SplitSlot>;
+
+    static constexpr size_t cache_line = 64;
+
+    bool try_push_packed(const T& item);
+    bool try_pop_packed(T& out_item);
+    bool try_push_split(const T& item);
+    bool try_pop_split(T& out_item);
+
+    static Word make_word(uint64_t payload, uint64_t tag);
+    static uint64_t payload_of(Word word);
+    static uint64_t tag_of(Word word);
+
+    // Reads a slot as two 64-bit halves; a torn read only makes the CAS fail.
+    static Word load_slot(const Slot& slot);
+    static bool cas_slot(Slot& slot, Word expected, Word desired);
+
+    uint64_t lap_of(size_t pos) const;
+
+    size_t capacity_;                                  // Number of slots, a power of two
+    size_t mask_;                                      // capacity_ - 1
+    unsigned shift_;                                   // log2(capacity_)
+    std::unique_ptr<Slot[]> slots_;                    // The underlying storage for elements
+    alignas(cache_line) std::atomic<size_t> tail_{0};  // Next position to be written
+    alignas(cache_line) std::atomic<size_t> head_{0};  // Next position to be read
+};
+
+template <typename T>
+TaggedRingBuffer<T>::TaggedRingBuffer(size_t capacity) {
+    if (capacity == 0) {
+        throw std::invalid_argument("TaggedRingBuffer capacity must be greater than 0.");
+    }
+    capacity_ = 1;
+    shift_ = 0;
+    while (capacity_ < capacity) {
+        if (capacity_ > (static_cast<size_t>(-1) >> 1)) {
+            throw std::invalid_argument("TaggedRingBuffer capacity is too large.");
+        }
+        capacity_ <<= 1;
+        ++shift_;
+    }
+    mask_ = capacity_ - 1;
+    slots_.reset(new Slot[capacity_]);
+    if constexpr (packed) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            slots_[i].word = make_word(0, 0);
+        }
+    }
+}
+
+template <typename T>
+bool TaggedRingBuffer<T>::try_push(const T& item) {
+    if constexpr (packed) {
+        return try_push_packed(item);
+    } else {
+        return try_push_split(item);
+    }
+}
+
+template <typename T>
+bool TaggedRingBuffer<T>::try_pop(T& out_item) {
+    if constexpr (packed) {
+        return try_pop_packed(out_item);
+    } else {
+        return try_pop_split(out_item);
+    }
+}
+
+template <typename T>
+bool TaggedRingBuffer<T>::try_push_packed(const T& item) {
+    uint64_t payload = 0;
+    std::memcpy(&payload, &item, sizeof(T));
+
+    size_t pos = tail_.load(ring_order::relaxed);
+    for (;;) {
+        Slot& slot = slots_[pos & mask_];
+        const Word current = load_slot(slot);
+        const uint64_t tag = tag_of(current);
+        const uint64_t empty_tag = 2 * lap_of(pos);
+
+        if (tag == empty_tag) {
+            // The slot CAS is the linearization point; advancing tail is
+            // bookkeeping that any thread may finish on our behalf.
+            if (cas_slot(slot, current, make_word(payload, empty_tag + 1))) {
+                tail_.compare_exchange_strong(pos, pos + 1, ring_order::relaxed);
+                return true;
+            }
+        } else if (tag == empty_tag + 1) {
+            // Filled by another producer that has not advanced tail yet.
+            tail_.compare_exchange_strong(pos, pos + 1, ring_order::relaxed);
+        } else if (tag < empty_tag) {
+            // Still holds an element from the previous lap.
+            const size_t now = tail_.load(ring_order::relaxed);
+            if (now == pos) {
+                return false;
+            }
+            pos = now;
+            continue;
+        }
+        pos = tail_.load(ring_order::relaxed);
+    }
+}
+
+template <typename T>
+bool TaggedRingBuffer<T>::try_pop_packed(T& out_item) {
+    size_t pos = head_.load(ring_order::relaxed);
+    for (;;) {
+        Slot& slot = slots_[pos & mask_];
+        const Word current = load_slot(slot);
+        const uint64_t tag = tag_of(current);
+        const uint64_t full_tag = 2 * lap_of(pos) + 1;
+
+        if (tag == full_tag) {
+            if (cas_slot(slot, current, make_word(0, full_tag + 1))) {
+                head_.compare_exchange_strong(pos, pos + 1, ring_order::relaxed);
+                const uint64_t payload = payload_of(current);
+                std::memcpy(&out_item, &payload, sizeof(T));
+                return true;
+            }
+        } else if (tag == full_tag + 1) {
+            // Drained by another consumer that has not advanced head yet.
+            head_.compare_exchange_strong(pos, pos + 1, ring_order::relaxed);
+        } else if (tag < full_tag) {
+            // Not yet filled for this lap.
+            const size_t now = head_.load(ring_order::relaxed);
+            if (now == pos) {
+                return false;
+            }
+            pos = now;
+            continue;
+        }
+        pos = head_.load(ring_order::relaxed);
+    }
+}
+
+template <typename T>
+bool TaggedRingBuffer<T>::try_push_split(const T& item) {
+    size_t pos = tail_.load(ring_order::relaxed);
+    for (;;) {
+        SplitSlot& slot = slots_[pos & mask_];
+        uint64_t tag = slot.tag.load(ring_order::relaxed);
+        const uint64_t empty_tag = 4 * lap_of(pos);
+
+        if (tag == empty_tag) {
+            // Acquire pairs with the consumer's release of the previous lap,
+            // so its read of the storage is done before we overwrite it.
+            if (slot.tag.compare_exchange_strong(tag, empty_tag + 1, ring_order::acquire, ring_order::relaxed)) {
+                tail_.compare_exchange_strong(pos, pos + 1, ring_order::relaxed);
+                std::memcpy(slot.storage, &item, sizeof(T));
+                slot.tag.store(empty_tag + 2, ring_order::release);
+                return true;
+            }
+        } else if (tag > empty_tag) {
+            // Claimed by another producer that has not advanced tail yet.
+            tail_.compare_exchange_strong(pos, pos + 1, ring_order::relaxed);
+        } else {
+            // Still holds an element from the previous lap.
+            const size_t now = tail_.load(ring_order::relaxed);
+            if (now == pos) {
+                return false;
+            }
+            pos = now;
+            continue;
+        }
+        pos = tail_.load(ring_order::relaxed);
+    }
+}
+
+template <typename T>
+bool TaggedRingBuffer<T>::try_pop_split(T& out_item) {
+    size_t pos = head_.load(ring_order::relaxed);
+    for (;;) {
+        SplitSlot& slot = slots_[pos & mask_];
+        uint64_t tag = slot.tag.load(ring_order::relaxed);
+        const uint64_t full_tag = 4 * lap_of(pos) + 2;
+
+        if (tag == full_tag) {
+            // Acquire pairs with the producer's release of the full tag.
+            if (slot.tag.compare_exchange_strong(tag, full_tag + 1, ring_order::acquire, ring_order::relaxed)) {
+                head_.compare_exchange_strong(pos, pos + 1, ring_order::relaxed);
+                std::memcpy(&out_item, slot.storage, sizeof(T));
+                slot.tag.store(full_tag + 2, ring_order::release);
+                return true;
+            }
+        } else if (tag > full_tag) {
+            // Claimed by another consumer that has not advanced head yet.
+            head_.compare_exchange_strong(pos, pos + 1, ring_order::relaxed);
+        } else {
+            // Empty or still being written for this lap.
+            const size_t now = head_.load(ring_order::relaxed);
+            if (now == pos) {
+                return false;
+            }
+            pos = now;
+            continue;
+        }
+        pos = head_.load(ring_order::relaxed);
+    }
+}
+
+template <typename T>
+size_t TaggedRingBuffer<T>::size() const {
+    const size_t head = head_.load(ring_order::relaxed);
+    const size_t tail = tail_.load(ring_order::relaxed);
+    const auto diff = static_cast<std::ptrdiff_t>(tail - head);
+    if (diff <= 0) {
+        return 0;
+    }
+    return static_cast<size_t>(diff) > capacity_ ? capacity_ : static_cast<size_t>(diff);
+}
+
+template <typename T>
+bool TaggedRingBuffer<T>::empty() const {
+    return size() == 0;
+}
+
+template <typename T>
+size_t TaggedRingBuffer<T>::capacity() const {
+    return capacity_;
+}
+
+template <typename T>
+typename TaggedRingBuffer<T>::Word TaggedRingBuffer<T>::make_word(uint64_t payload, uint64_t tag) {
+    return (static_cast<Word>(tag) << 64) | payload;
+}
+
+template <typename T>
+uint64_t TaggedRingBuffer<T>::payload_of(Word word) {
+    return static_cast<uint64_t>(word);
+}
+
+template <typename T>
+uint64_t TaggedRingBuffer<T>::tag_of(Word word) {
+    return static_cast<uint64_t>(word >> 64);
+}
+
+template <typename T>
+typename TaggedRingBuffer<T>::Word TaggedRingBuffer<T>::load_slot(const Slot& slot) {
+    using Half = uint64_t __attribute__((may_alias));
+    const Half* halves = reinterpret_cast<const Half*>(&slot.word);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    const uint64_t tag = __atomic_load_n(&halves[1], ring_order::builtin(ring_order::relaxed));
+    const uint64_t payload = __atomic_load_n(&halves[0], ring_order::builtin(ring_order::relaxed));
+#else
+    const uint64_t tag = __atomic_load_n(&halves[0], ring_order::builtin(ring_order::relaxed));
+    const uint64_t payload = __atomic_load_n(&halves[1], ring_order::builtin(ring_order::relaxed));
+#endif
+    return make_word(payload, tag);
+}
+
+template <typename T>
+bool TaggedRingBuffer<T>::cas_slot(Slot& slot, Word expected, Word desired) {
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+    return __sync_bool_compare_and_swap(&slot.word, expected, desired);
+#else
+    return __atomic_compare_exchange_n(&slot.word, &expected, desired, false, ring_order::builtin(ring_order::acq_rel),
+                                       ring_order::builtin(ring_order::relaxed));
+#endif
+}
+
+template <typename T>
+uint64_t TaggedRingBuffer<T>::lap_of(size_t pos) const {
+    return static_cast<uint64_t>(pos >> shift_);
+}
+
+#endif // RING_BUFFER_TAGGED_HPP
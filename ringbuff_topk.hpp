@@ -0,0 +1,241 @@
+#ifndef RING_BUFFER_TOPK_HPP
+#define RING_BUFFER_TOPK_HPP
+
+#include <algorithm>      // For std::min
+#include <cstddef>        // For size_t
+#include <cstdint>        // For uint64_t
+#include <functional>     // For std::hash, std::equal_to
+#include <stdexcept>      // For std::invalid_argument, std::out_of_range
+#include <unordered_map>  // For std::unordered_map
+#include <utility>        // For std::pair, std::swap
+#include <vector>         // For std::vector
+
+#include "ringbuff.hpp"
+
+// Exact per-key counts kept in descending order, so the K most frequent keys
+// can be read in O(K). Keys live in an array sorted by count, and each run of
+// equal counts (a bucket, as in the space-saving stream summary) records where
+// it starts. Adding or removing one occurrence swaps the key with the edge of
+// its bucket and moves that edge, which is O(1) expected instead of the
+// O(log K) of a heap, and works in both directions, so counts can follow a
+// sliding window. Keys whose count drops to 0 are forgotten.
+template <typename Key, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class TopKCounter {
+public:
+    // Adds one occurrence of key.
+    void increment(const Key& key);
+
+    // Removes one occurrence of key.
+    // Throws std::out_of_range if key has no occurrences.
+    void decrement(const Key& key);
+
+    // Returns the number of occurrences of key.
+    uint64_t count(const Key& key) const;
+
+    // Returns up to k (key, count) pairs with the highest counts, highest first,
+    // in O(k). Keys with equal counts come in no particular order.
+    std::vector<std::pair<Key, uint64_t>> top(size_t k) const;
+
+    // Returns the number of keys with at least one occurrence.
+    size_t keys() const;
+
+    // Forgets every key.
+    void clear();
+
+private:
+    struct Item {
+        const Key* key;    // The key stored in index_
+        uint64_t count;
+        size_t* position;  // The key's position in index_, updated on every move
+    };
+
+    // Buckets that empty out are kept and reused, so the bucket map does not
+    // allocate on every update. Their number is bounded by the largest count.
+    struct Bucket {
+        size_t first = 0;  // Position in order_ of the first key with this count
+        size_t size = 0;   // Number of keys with this count
+    };
+
+    void join_bucket(uint64_t count, size_t position);
+    void swap_positions(size_t a, size_t b);
+
+    std::vector<Item> order_;                                 // Keys by descending count
+    std::unordered_map<Key, size_t, Hash, KeyEqual> index_;  // Key to position in order_
+    std::unordered_map<uint64_t, Bucket> buckets_;            // Count to its run in order_
+};
+
+// Top-K of the keys pushed within a sliding window.
+// Entries are kept in a RingBuffer. push() counts the key and, once the ring is
+// full, uncounts the entry it overwrites; expire() uncounts the entries older
+// than a timestamp, so the window can be a count of events, a span of time, or
+// both. Key must be default constructible.
+template <typename Key, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class WindowedTopK {
+public:
+    // Constructs a window holding at most `capacity` entries.
+    // Throws std::invalid_argument if capacity is 0.
+    explicit WindowedTopK(size_t capacity);
+
+    // Adds an occurrence of key at `timestamp`, evicting the oldest entry when full.
+    // Timestamps must not decrease.
+    void push(const Key& key, uint64_t timestamp = 0);
+
+    // Evicts every entry with a timestamp below `before`. Returns the number evicted.
+    size_t expire(uint64_t before);
+
+    // Returns up to k (key, count) pairs with the highest counts in the window, in O(k).
+    std::vector<std::pair<Key, uint64_t>> top(size_t k) const;
+
+    // Returns the number of occurrences of key in the window.
+    uint64_t count(const Key& key) const;
+
+    // Returns the number of entries in the window.
+    size_t size() const;
+
+    // Returns the maximum number of entries in the window.
+    size_t capacity() const;
+
+private:
+    struct Entry {
+        uint64_t timestamp;
+        Key key;
+    };
+
+    RingBuffer<Entry> window_;
+    TopKCounter<Key, Hash, KeyEqual> counts_;
+};
+
+template <typename Key, typename Hash, typename KeyEqual>
+void TopKCounter<Key, Hash, KeyEqual>::increment(const Key& key) {
+    auto [found, inserted] = index_.try_emplace(key, order_.size());
+    if (inserted) {
+        // A count of 1 is the lowest, so a new key belongs at the end.
+        order_.push_back(Item{&found->first, 1, &found->second});
+        join_bucket(1, found->second);
+        return;
+    }
+
+    const uint64_t old_count = order_[found->second].count;
+    Bucket& old_bucket = buckets_.find(old_count)->second;
+    const size_t edge = old_bucket.first;
+    swap_positions(found->second, edge);
+    ++order_[edge].count;
+    ++old_bucket.first;
+    --old_bucket.size;
+    // The next higher bucket, if any, ends right before edge.
+    join_bucket(old_count + 1, edge);
+}
+
+template <typename Key, typename Hash, typename KeyEqual>
+void TopKCounter<Key, Hash, KeyEqual>::decrement(const Key& key) {
+    auto found = index_.find(key);
+    if (found == index_.end()) {
+        throw std::out_of_range("Cannot decrement a key TopKCounter does not hold.");
+    }
+
+    const uint64_t old_count = order_[found->second].count;
+    Bucket& old_bucket = buckets_.find(old_count)->second;
+    const size_t edge = old_bucket.first + old_bucket.size - 1;
+    swap_positions(found->second, edge);
+    --order_[edge].count;
+    --old_bucket.size;
+    if (old_count == 1) {
+        // The 1 bucket is last, so the key now sits at the end.
+        order_.pop_back();
+        index_.erase(found);
+        return;
+    }
+    // The next lower bucket, if any, starts right after edge.
+    join_bucket(old_count - 1, edge);
+}
+
+template <typename Key, typename Hash, typename KeyEqual>
+uint64_t TopKCounter<Key, Hash, KeyEqual>::count(const Key& key) const {
+    auto found = index_.find(key);
+    return found == index_.end() ? 0 : order_[found->second].count;
+}
+
+template <typename Key, typename Hash, typename KeyEqual>
+std::vector<std::pair<Key, uint64_t>> TopKCounter<Key, Hash, KeyEqual>::top(size_t k) const {
+    std::vector<std::pair<Key, uint64_t>> result;
+    result.reserve(std::min(k, order_.size()));
+    for (size_t i = 0; i < order_.size() && i < k; ++i) {
+        result.emplace_back(*order_[i].key, order_[i].count);
+    }
+    return result;
+}
+
+template <typename Key, typename Hash, typename KeyEqual>
+size_t TopKCounter<Key, Hash, KeyEqual>::keys() const {
+    return order_.size();
+}
+
+template <typename Key, typename Hash, typename KeyEqual>
+void TopKCounter<Key, Hash, KeyEqual>::clear() {
+    order_.clear();
+    index_.clear();
+    buckets_.clear();
+}
+
+template <typename Key, typename Hash, typename KeyEqual>
+void TopKCounter<Key, Hash, KeyEqual>::join_bucket(uint64_t count, size_t position) {
+    // position is adjacent to the bucket's run, or the bucket is empty.
+    Bucket& bucket = buckets_[count];
+    bucket.first = bucket.size == 0 ? position : std::min(bucket.first, position);
+    ++bucket.size;
+}
+
+template <typename Key, typename Hash, typename KeyEqual>
+void TopKCounter<Key, Hash, KeyEqual>::swap_positions(size_t a, size_t b) {
+    if (a == b) {
+        return;
+    }
+    std::swap(order_[a], order_[b]);
+    *order_[a].position = a;
+    *order_[b].position = b;
+}
+
+template <typename Key, typename Hash, typename KeyEqual>
+WindowedTopK<Key, Hash, KeyEqual>::WindowedTopK(size_t capacity) : window_(capacity) {}
+
+template <typename Key, typename Hash, typename KeyEqual>
+void WindowedTopK<Key, Hash, KeyEqual>::push(const Key& key, uint64_t timestamp) {
+    if (window_.full()) {
+        counts_.decrement(window_.front().key);
+    }
+    window_.push(Entry{timestamp, key});
+    counts_.increment(key);
+}
+
+template <typename Key, typename Hash, typename KeyEqual>
+size_t WindowedTopK<Key, Hash, KeyEqual>::expire(uint64_t before) {
+    size_t evicted = 0;
+    while (!window_.empty() && window_.front().timestamp < before) {
+        counts_.decrement(window_.front().key);
+        window_.discard(1);
+        ++evicted;
+    }
+    return evicted;
+}
+
+template <typename Key, typename Hash, typename KeyEqual>
+std::vector<std::pair<Key, uint64_t>> WindowedTopK<Key, Hash, KeyEqual>::top(size_t k) const {
+    return counts_.top(k);
+}
+
+template <typename Key, typename Hash, typename KeyEqual>
+uint64_t WindowedTopK<Key, Hash, KeyEqual>::count(const Key& key) const {
+    return counts_.count(key);
+}
+
+template <typename Key, typename Hash, typename KeyEqual>
+size_t WindowedTopK<Key, Hash, KeyEqual>::size() const {
+    return window_.size();
+}
+
+template <typename Key, typename Hash, typename KeyEqual>
+size_t WindowedTopK<Key, Hash, KeyEqual>::capacity() const {
+    return window_.capacity();
+}
+
+#endif // RING_BUFFER_TOPK_HPP
@@ -0,0 +1,381 @@
+#include "ringbuff_trace.hpp"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t dump_magic = 0x52464252;  // "RBFR"
+constexpr uint32_t dump_version = 1;
+
+// Layout of a dump, in host byte order: DumpHeader, name_count name entries,
+// then per thread a ThreadHeader followed by its events, oldest first.
+struct DumpHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t thread_count;
+    uint32_t name_count;
+    uint64_t start_tsc;  // Counter and CLOCK_MONOTONIC read together at construction
+    uint64_t start_ns;
+    uint64_t dump_tsc;   // ... and again when the dump was taken
+    uint64_t dump_ns;
+};
+
+struct ThreadHeader {
+    uint32_t os_thread_id;
+    uint32_t reserved;
+    uint64_t event_count;
+};
+
+struct DumpName {
+    uint16_t id;
+    char name[30];
+};
+
+std::atomic<uint64_t> next_recorder_id{1};
+
+// Ids of the recorders not yet destroyed. A thread exiting holds the lock
+// while it releases its rings, so no recorder frees them underneath it.
+std::mutex live_recorders_mutex;
+std::vector<uint64_t> live_recorders;
+
+// A ring this thread owns, with its recorder's id, the ring's release flag
+// and the recorder's count of released rings.
+struct OwnedRing {
+    uint64_t recorder_id;
+    void* ring;
+    std::atomic<bool>* released;
+    std::atomic<uint64_t>* release_count;
+};
+
+// Per-thread state: the rings this thread owns in each recorder it has
+// recorded into, and the alternate signal stack set up for the crash handler.
+// Both are given back when the thread exits.
+struct ThreadState {
+    std::vector<OwnedRing> rings;
+    std::unique_ptr<char[]> alt_stack;
+
+    ~ThreadState() {
+        {
+            std::lock_guard<std::mutex> lock(live_recorders_mutex);
+            for (const OwnedRing& owned : rings) {
+                if (std::find(live_recorders.begin(), live_recorders.end(), owned.recorder_id) !=
+                    live_recorders.end()) {
+                    owned.released->store(true, std::memory_order_release);
+                    owned.release_count->fetch_add(1, std::memory_order_release);
+                }
+            }
+        }
+        if (alt_stack) {
+            stack_t disable{};
+            disable.ss_flags = SS_DISABLE;
+            sigaltstack(&disable, nullptr);
+        }
+    }
+};
+
+thread_local ThreadState thread_state;
+
+// Gives the calling thread an alternate signal stack unless it has one.
+void ensure_alt_stack() {
+    if (thread_state.alt_stack) {
+        return;
+    }
+    stack_t current{};
+    if (sigaltstack(nullptr, &current) != 0 || (current.ss_flags & SS_DISABLE) == 0) {
+        return;  // Unknown, or set up by someone else
+    }
+    // SIGSTKSZ is not a constant on newer glibc; dump() needs little of it.
+    const size_t size = std::max<size_t>(SIGSTKSZ, 64 * 1024);
+    auto stack = std::make_unique<char[]>(size);
+    stack_t alternate{};
+    alternate.ss_sp = stack.get();
+    alternate.ss_size = size;
+    if (sigaltstack(&alternate, nullptr) == 0) {
+        thread_state.alt_stack = std::move(stack);
+    }
+}
+
+// The recorder dumped by the crash handler and where it goes.
+std::atomic<const FlightRecorder*> crash_recorder{nullptr};
+char crash_path[4096];
+
+constexpr int crash_signals[] = {SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT};
+
+bool write_fully(int fd, const void* data, size_t size) {
+    const char* p = static_cast<const char*>(data);
+    while (size > 0) {
+        const ssize_t n = write(fd, p, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void crash_handler(int signal) {
+    const int saved_errno = errno;
+    if (const FlightRecorder* recorder = crash_recorder.exchange(nullptr)) {
+        recorder->dump(crash_path);
+    }
+    errno = saved_errno;
+    // SA_RESETHAND restored the default action; re-raise to get it (core dump, exit status).
+    raise(signal);
+}
+
+void read_exact(std::istream& in, void* data, size_t size) {
+    if (!in.read(static_cast<char*>(data), static_cast<std::streamsize>(size))) {
+        throw std::runtime_error("Flight recorder dump truncated.");
+    }
+}
+
+void write_json_string(std::ostream& out, const char* text) {
+    out << '"';
+    for (; *text != '\0'; ++text) {
+        const char c = *text;
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << ' ';
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+}  // namespace
+
+FlightRecorder::FlightRecorder(size_t events_per_thread, size_t max_threads)
+    : id_(next_recorder_id.fetch_add(1, std::memory_order_relaxed)),
+      events_per_thread_(events_per_thread),
+      max_threads_(max_threads) {
+    if (events_per_thread == 0 || max_threads == 0) {
+        throw std::invalid_argument("FlightRecorder limits must be greater than 0.");
+    }
+    rings_.reset(new std::atomic<ThreadRing*>[max_threads_]);
+    for (size_t i = 0; i < max_threads_; ++i) {
+        rings_[i].store(nullptr, std::memory_order_relaxed);
+    }
+    names_.reset(new EventName[max_event_names]);
+    start_ = TscClock::sample();
+    std::lock_guard<std::mutex> lock(live_recorders_mutex);
+    live_recorders.push_back(id_);
+}
+
+FlightRecorder::~FlightRecorder() {
+    const FlightRecorder* expected = this;
+    crash_recorder.compare_exchange_strong(expected, nullptr);
+    {
+        std::lock_guard<std::mutex> lock(live_recorders_mutex);
+        live_recorders.erase(std::find(live_recorders.begin(), live_recorders.end(), id_));
+    }
+    const size_t count = ring_count_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+        delete rings_[i].load(std::memory_order_relaxed);
+    }
+}
+
+FlightRecorder::ThreadRing* FlightRecorder::claim_ring() {
+    ThreadRing* ring = nullptr;
+    for (const OwnedRing& owned : thread_state.rings) {
+        if (owned.recorder_id == id_) {
+            ring = static_cast<ThreadRing*>(owned.ring);
+        }
+    }
+    if (ring != nullptr) {
+        last_ring_ = LastRing{id_, ring, 0};
+        return ring;
+    }
+    // Read before the search, so a ring released during it is not missed.
+    const uint64_t released = released_.load(std::memory_order_acquire);
+    const uint32_t os_thread_id = static_cast<uint32_t>(syscall(SYS_gettid));
+
+    // First take over the ring of a thread that has exited.
+    const size_t published = ring_count_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < published && ring == nullptr; ++i) {
+        ThreadRing* candidate = rings_[i].load(std::memory_order_acquire);
+        bool free = true;
+        if (candidate != nullptr &&
+            candidate->released.compare_exchange_strong(free, false, std::memory_order_acquire)) {
+            // A dump taken meanwhile may mix the two threads' events under the new id.
+            candidate->os_thread_id.store(os_thread_id, std::memory_order_relaxed);
+            candidate->events.clear();
+            ring = candidate;
+        }
+    }
+
+    if (ring == nullptr) {
+        size_t slot = ring_count_.load(std::memory_order_relaxed);
+        // Slots are claimed in order so dump() can walk a prefix of rings_.
+        while (slot < max_threads_ &&
+               !ring_count_.compare_exchange_weak(slot, slot + 1, std::memory_order_acq_rel)) {
+        }
+        if (slot >= max_threads_) {
+            last_ring_ = LastRing{id_, nullptr, released};
+            return nullptr;
+        }
+        ring = new ThreadRing(events_per_thread_);
+        ring->os_thread_id.store(os_thread_id, std::memory_order_relaxed);
+        rings_[slot].store(ring, std::memory_order_release);
+    }
+    thread_state.rings.push_back(OwnedRing{id_, ring, &ring->released, &released_});
+    ensure_alt_stack();
+    last_ring_ = LastRing{id_, ring, 0};
+    return ring;
+}
+
+void FlightRecorder::name_event(uint16_t id, const std::string& name) {
+    std::lock_guard<std::mutex> lock(names_mutex_);
+    const size_t count = name_count_.load(std::memory_order_relaxed);
+    if (count == max_event_names) {
+        throw std::length_error("FlightRecorder event name table is full.");
+    }
+    EventName& entry = names_[count];
+    entry.id = id;
+    const size_t length = std::min(name.size(), sizeof(entry.name) - 1);
+    std::memcpy(entry.name, name.data(), length);
+    entry.name[length] = '\0';
+    name_count_.store(count + 1, std::memory_order_release);
+}
+
+bool FlightRecorder::dump(const char* path) const {
+    const int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    const bool written = dump_fd(fd);
+    return close(fd) == 0 && written;
+}
+
+bool FlightRecorder::dump_fd(int fd) const {
+    // Nothing here may allocate or lock: this runs inside signal handlers.
+    size_t threads = ring_count_.load(std::memory_order_acquire);
+    while (threads > 0 && rings_[threads - 1].load(std::memory_order_acquire) == nullptr) {
+        --threads;  // Claimed but not yet published
+    }
+    const size_t names = name_count_.load(std::memory_order_acquire);
+
+    const TscClock::Sample now = TscClock::sample();
+    DumpHeader header{dump_magic, dump_version, static_cast<uint32_t>(threads), static_cast<uint32_t>(names),
+                      start_.tsc, start_.ns, now.tsc, now.ns};
+    if (!write_fully(fd, &header, sizeof(header))) {
+        return false;
+    }
+    for (size_t i = 0; i < names; ++i) {
+        DumpName entry{};
+        entry.id = names_[i].id;
+        std::memcpy(entry.name, names_[i].name, sizeof(entry.name));
+        if (!write_fully(fd, &entry, sizeof(entry))) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        const ThreadRing* ring = rings_[i].load(std::memory_order_acquire);
+        if (ring == nullptr) {
+            ThreadHeader empty{0, 0, 0};
+            if (!write_fully(fd, &empty, sizeof(empty))) {
+                return false;
+            }
+            continue;
+        }
+        // The owner may still be recording; a dump taken meanwhile can hold a torn event.
+        const auto [first, second] = ring->events.segments();
+        ThreadHeader thread{ring->os_thread_id.load(std::memory_order_relaxed), 0, first.size() + second.size()};
+        if (!write_fully(fd, &thread, sizeof(thread)) ||
+            !write_fully(fd, first.data(), first.size_bytes()) ||
+            !write_fully(fd, second.data(), second.size_bytes())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FlightRecorder::install_crash_handler(const std::string& path) {
+    if (path.size() >= sizeof(crash_path)) {
+        throw std::invalid_argument("FlightRecorder crash dump path is too long.");
+    }
+    crash_recorder.store(nullptr);
+    std::memcpy(crash_path, path.c_str(), path.size() + 1);
+    crash_recorder.store(this);
+    ensure_alt_stack();
+
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = crash_handler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESETHAND | SA_ONSTACK;
+    for (int signal : crash_signals) {
+        sigaction(signal, &action, nullptr);
+    }
+}
+
+uint64_t FlightRecorder::dropped() const {
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+void trace_to_chrome_json(std::istream& dump, std::ostream& json) {
+    DumpHeader header;
+    read_exact(dump, &header, sizeof(header));
+    if (header.magic != dump_magic || header.version != dump_version) {
+        throw std::runtime_error("Not a flight recorder dump.");
+    }
+
+    std::unordered_map<uint16_t, std::string> names;
+    for (uint32_t i = 0; i < header.name_count; ++i) {
+        DumpName entry;
+        read_exact(dump, &entry, sizeof(entry));
+        entry.name[sizeof(entry.name) - 1] = '\0';
+        names[entry.id] = entry.name;
+    }
+
+    // Counter ticks are converted to microseconds since the recorder started.
+    const double ticks = static_cast<double>(header.dump_tsc - header.start_tsc);
+    const double ns_per_tick = ticks > 0 ? static_cast<double>(header.dump_ns - header.start_ns) / ticks : 1.0;
+
+    json << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first_event = true;
+    for (uint32_t t = 0; t < header.thread_count; ++t) {
+        ThreadHeader thread;
+        read_exact(dump, &thread, sizeof(thread));
+        for (uint64_t e = 0; e < thread.event_count; ++e) {
+            TraceEvent event;
+            read_exact(dump, &event, sizeof(event));
+            json << (first_event ? "\n" : ",\n");
+            first_event = false;
+
+            json << "{\"name\":";
+            const auto name = names.find(event.id);
+            if (name != names.end()) {
+                write_json_string(json, name->second.c_str());
+            } else {
+                json << "\"event " << event.id << '"';
+            }
+            const char* phase = event.phase == TracePhase::Begin ? "B" : event.phase == TracePhase::End ? "E" : "i";
+            const double ts =
+                static_cast<double>(static_cast<int64_t>(event.tsc - header.start_tsc)) * ns_per_tick / 1000.0;
+            json << ",\"ph\":\"" << phase << "\",\"ts\":" << ts << ",\"pid\":1,\"tid\":" << thread.os_thread_id;
+            if (event.phase == TracePhase::Instant) {
+                json << ",\"s\":\"t\"";
+            }
+            json << ",\"args\":{\"arg0\":" << event.arg0 << ",\"arg1\":" << event.arg1 << ",\"arg2\":" << event.arg2
+                 << "}}";
+        }
+    }
+    json << "\n]}\n";
+}
@@ -0,0 +1,165 @@
+#ifndef RING_BUFFER_TRACE_HPP
+#define RING_BUFFER_TRACE_HPP
+
+#include <atomic>     // For std::atomic
+#include <cstddef>    // For size_t
+#include <cstdint>    // For uint8_t, uint16_t, uint32_t, uint64_t
+#include <istream>    // For std::istream
+#include <memory>     // For std::unique_ptr
+#include <mutex>      // For std::mutex
+#include <ostream>    // For std::ostream
+#include <string>     // For std::string
+
+#include "ringbuff.hpp"
+#include "ringbuff_clock.hpp"
+
+// Phase of a trace event, as in the Chrome trace event format.
+enum class TracePhase : uint8_t {
+    Instant,  // A point in time
+    Begin,    // Start of a span on this thread
+    End,      // End of the innermost open span on this thread
+};
+
+// One compact binary trace event.
+struct TraceEvent {
+    uint64_t tsc;       // TscClock::now() when the event was recorded
+    uint16_t id;        // Event identifier, named with FlightRecorder::name_event()
+    TracePhase phase;   // Instant, Begin or End
+    uint8_t reserved;   // Zero
+    uint32_t arg0;      // Free-form arguments
+    uint64_t arg1;
+    uint64_t arg2;
+};
+static_assert(sizeof(TraceEvent) == 32, "TraceEvent must stay 32 bytes");
+
+// An always-on flight recorder.
+// Every thread that records gets its own overwriting RingBuffer<TraceEvent>,
+// so recording is a counter read and a push into memory no other thread
+// writes. The rings keep the most recent events of each thread and can be
+// dumped at any time, including from a crash signal handler: dump() only
+// uses open(), write() and close(). trace_to_chrome_json() converts a dump
+// into the Chrome trace event format (chrome://tracing, Perfetto).
+class FlightRecorder {
+public:
+    // Constructs a recorder that keeps the last events_per_thread events of
+    // each of up to max_threads threads recording at once. When a thread exits,
+    // its ring goes to the next thread that starts recording, which clears it;
+    // until then, dumps still hold the exited thread's events. Events from
+    // threads beyond the limit are dropped.
+    // Throws std::invalid_argument if either limit is 0.
+    explicit FlightRecorder(size_t events_per_thread = 16384, size_t max_threads = 256);
+
+    // Uninstalls the crash handler if it dumps this recorder.
+    ~FlightRecorder();
+
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    // Records an event on the calling thread's ring, overwriting its oldest event when full.
+    void record(uint16_t id, TracePhase phase = TracePhase::Instant, uint32_t arg0 = 0, uint64_t arg1 = 0,
+                uint64_t arg2 = 0);
+
+    // Gives an event id a name for the decoder. Names longer than 29 characters are cut.
+    // Throws std::length_error once max_event_names ids have been named.
+    void name_event(uint16_t id, const std::string& name);
+
+    // Writes every thread's ring to a file, oldest event first.
+    // Async-signal-safe. Returns false if the file cannot be written.
+    bool dump(const char* path) const;
+
+    // Same as dump(const char*), writing to an open file descriptor.
+    bool dump_fd(int fd) const;
+
+    // Makes SIGSEGV, SIGBUS, SIGILL, SIGFPE and SIGABRT dump this recorder to
+    // `path` before the default action runs. Only one recorder can be installed at a time.
+    // The handler runs on an alternate signal stack, so a stack overflow is dumped
+    // too; one is set up for the calling thread and for each thread when it first
+    // records, unless the thread already has its own.
+    // Throws std::invalid_argument if the path is too long.
+    void install_crash_handler(const std::string& path);
+
+    // Returns the number of events dropped because max_threads live threads were already recording.
+    uint64_t dropped() const;
+
+    static constexpr size_t max_event_names = 1024;
+
+private:
+    struct ThreadRing {
+        explicit ThreadRing(size_t capacity) : events(capacity) {}
+
+        RingBuffer<TraceEvent> events;
+        std::atomic<uint32_t> os_thread_id{0};
+        std::atomic<bool> released{false};  // Set when the owning thread exits
+    };
+
+    struct EventName {
+        uint16_t id;
+        char name[30];  // NUL-terminated
+    };
+
+    // Fast path cache of the calling thread's ring in the most recently used recorder.
+    struct LastRing {
+        uint64_t recorder_id;
+        ThreadRing* ring;
+        uint64_t released;  // released_ when no ring was left, so the thread looks again once it changes
+    };
+
+    ThreadRing* local_ring();
+    ThreadRing* claim_ring();  // Looks up, reuses or creates the calling thread's ring; nullptr if none is left
+
+    static inline thread_local LastRing last_ring_{};
+
+    uint64_t id_;                                    // Unique for the lifetime of the process
+    size_t events_per_thread_;
+    size_t max_threads_;
+    std::unique_ptr<std::atomic<ThreadRing*>[]> rings_;  // Claimed in order, reused after their threads exit
+    std::atomic<size_t> ring_count_{0};               // Rings published in rings_
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> released_{0};               // Rings released by exiting threads so far
+    std::mutex names_mutex_;                          // Serializes name_event()
+    std::unique_ptr<EventName[]> names_;
+    std::atomic<size_t> name_count_{0};
+    TscClock::Sample start_;                          // Paired with a dump-time sample to convert ticks
+};
+
+// RAII helper that records a Begin event now and the matching End event on scope exit.
+class TraceScope {
+public:
+    TraceScope(FlightRecorder& recorder, uint16_t id, uint32_t arg0 = 0) : recorder_(recorder), id_(id) {
+        recorder_.record(id_, TracePhase::Begin, arg0);
+    }
+
+    ~TraceScope() {
+        recorder_.record(id_, TracePhase::End);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    FlightRecorder& recorder_;
+    uint16_t id_;
+};
+
+// Converts a FlightRecorder dump into Chrome trace event JSON.
+// Throws std::runtime_error if the dump is truncated or not a flight recorder dump.
+void trace_to_chrome_json(std::istream& dump, std::ostream& json);
+
+inline FlightRecorder::ThreadRing* FlightRecorder::local_ring() {
+    if (last_ring_.recorder_id == id_ &&
+        (last_ring_.ring != nullptr || last_ring_.released == released_.load(std::memory_order_relaxed))) {
+        return last_ring_.ring;
+    }
+    return claim_ring();
+}
+
+inline void FlightRecorder::record(uint16_t id, TracePhase phase, uint32_t arg0, uint64_t arg1, uint64_t arg2) {
+    ThreadRing* ring = local_ring();
+    if (ring == nullptr) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    ring->events.push(TraceEvent{TscClock::now(), id, phase, 0, arg0, arg1, arg2});
+}
+
+#endif // RING_BUFFER_TRACE_HPP
@@ -0,0 +1,309 @@
+#ifndef RING_BUFFER_UNBOUNDED_HPP
+#define RING_BUFFER_UNBOUNDED_HPP
+
+#include <atomic>       // For std::atomic
+#include <cstddef>      // For size_t
+#include <cstdint>      // For uint8_t
+#include <limits>       // For std::numeric_limits
+#include <memory>       // For std::unique_ptr
+#include <mutex>        // For std::mutex, std::lock_guard
+#include <new>          // For placement new, std::launder
+#include <stdexcept>    // For std::invalid_argument
+#include <type_traits>  // For std::is_nothrow_move_constructible_v
+#include <utility>      // For std::forward, std::move
+#include <vector>       // For std::vector
+
+#include "ringbuff_epoch.hpp"
+#include "ringbuff_memory_order.hpp"
+
+// An unbounded lock-free multi-producer/multi-consumer queue built from linked
+// fixed-size ring segments.
+// Producers and consumers claim slots inside the current segment with a single
+// fetch_add each and never block one another there. Only threads that run off
+// the end of a segment synchronize, to link a fresh segment or unlink a drained
+// one. Drained segments are recycled through a free list instead of going back
+// to the allocator, and an optional ceiling caps the number of segments so the
+// queue degrades into a bounded one under sustained overload.
+// Segment recycling is protected by epoch-based reclamation, so a segment is
+// only reused once no thread can still be operating inside it.
+template <typename T>
+class UnboundedRing {
+    static_assert(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>,
+                  "UnboundedRing requires nothrow move operations");
+
+public:
+    // Constructs an empty queue whose segments hold `segment_capacity` elements.
+    // At most `max_segments` segments are ever allocated (including recycled ones)
+    // and at most `max_threads` threads may use the queue concurrently.
+    // Throws std::invalid_argument if any of the limits is 0.
+    explicit UnboundedRing(size_t segment_capacity = 1024,
+                           size_t max_segments = std::numeric_limits<size_t>::max(),
+                           size_t max_threads = 256);
+
+    // Destroys any elements still in the queue and releases all segments.
+    ~UnboundedRing();
+
+    UnboundedRing(const UnboundedRing&) = delete;
+    UnboundedRing& operator=(const UnboundedRing&) = delete;
+
+    // Attempts to add an element to the back of the queue (copy version).
+    // Returns true if successful, false if a new segment was needed and the
+    // segment ceiling has been reached.
+    bool try_push(const T& item);
+
+    // Attempts to add an element to the back of the queue (move version).
+    // Returns true if successful, false if the segment ceiling has been reached.
+    bool try_push(T&& item);
+
+    // Attempts to remove the oldest element and move it into out_item.
+    // Returns true if successful, false if the queue is empty.
+    bool try_pop(T& out_item);
+
+    // Checks if the queue looked empty at some recent instant.
+    bool empty() const;
+
+    // Returns the number of elements each segment holds.
+    size_t segment_capacity() const;
+
+    // Returns the number of segments allocated so far, linked or recycled.
+    size_t allocated_segments() const;
+
+private:
+    enum CellState : uint8_t { Empty, Writing, Full, Taken };
+
+    struct Cell {
+        std::atomic<uint8_t> state{Empty};            // Empty, Writing, Full or Taken
+        alignas(T) unsigned char storage[sizeof(T)];  // Raw storage for one element
+    };
+
+    struct Segment {
+        explicit Segment(size_t capacity) : cells(new Cell[capacity]) {}
+
+        std::atomic<size_t> enqueue_index{0};  // Next cell to claim for writing
+        std::atomic<size_t> dequeue_index{0};  // Next cell to claim for reading
+        std::atomic<Segment*> next{nullptr};   // Following segment in the queue
+        std::unique_ptr<Cell[]> cells;         // The segment's ring storage
+    };
+
+    // Constructs the element in the queue, reporting false at the segment ceiling.
+    template <typename U>
+    bool enqueue(U&& item);
+
+    // Returns an empty segment from the free list or the allocator, or nullptr
+    // if the ceiling has been reached.
+    Segment* acquire_segment();
+
+    // Puts a segment that no thread can reach on the free list.
+    void release_segment(Segment* segment);
+
+    void reset_segment(Segment* segment);
+
+    static constexpr size_t cache_line = 64;
+
+    size_t segment_capacity_;                                 // Elements per segment
+    size_t max_segments_;                                     // Segment ceiling
+    alignas(cache_line) std::atomic<Segment*> tail_;          // Segment producers write into
+    alignas(cache_line) std::atomic<Segment*> head_;          // Segment consumers read from
+    alignas(cache_line) mutable std::mutex pool_mutex_;       // Guards the lists below
+    std::vector<std::unique_ptr<Segment>> segments_;          // Every segment ever allocated
+    std::vector<Segment*> free_;                              // Segments ready for reuse
+    EpochDomain epoch_;                                       // Defers recycling of unlinked segments
+};
+
+template <typename T>
+UnboundedRing<T>::UnboundedRing(size_t segment_capacity, size_t max_segments, size_t max_threads)
+    : segment_capacity_(segment_capacity), max_segments_(max_segments), epoch_(max_threads) {
+    if (segment_capacity == 0) {
+        throw std::invalid_argument("UnboundedRing segment capacity must be greater than 0.");
+    }
+    if (max_segments == 0) {
+        throw std::invalid_argument("UnboundedRing must allow at least one segment.");
+    }
+    segments_.push_back(std::make_unique<Segment>(segment_capacity_));
+    tail_.store(segments_.back().get(), ring_order::relaxed);
+    head_.store(segments_.back().get(), ring_order::relaxed);
+}
+
+template <typename T>
+UnboundedRing<T>::~UnboundedRing() {
+    for (Segment* segment = head_.load(ring_order::relaxed); segment != nullptr;
+         segment = segment->next.load(ring_order::relaxed)) {
+        for (size_t i = 0; i < segment_capacity_; ++i) {
+            if (segment->cells[i].state.load(ring_order::relaxed) == Full) {
+                std::launder(reinterpret_cast<T*>(segment->cells[i].storage))->~T();
+            }
+        }
+    }
+}
+
+template <typename T>
+bool UnboundedRing<T>::try_push(const T& item) {
+    return enqueue(T(item));
+}
+
+template <typename T>
+bool UnboundedRing<T>::try_push(T&& item) {
+    return enqueue(std::move(item));
+}
+
+template <typename T>
+template <typename U>
+bool UnboundedRing<T>::enqueue(U&& item) {
+    // A fresh segment is acquired outside the critical section: collecting
+    // while pinned would hold back the very epoch the free list waits on.
+    Segment* spare = nullptr;
+    for (;;) {
+        {
+            auto guard = epoch_.pin();
+            Segment* tail = tail_.load(ring_order::acquire);
+            const size_t index = tail->enqueue_index.fetch_add(1, ring_order::relaxed);
+
+            if (index < segment_capacity_) {
+                Cell& cell = tail->cells[index];
+                uint8_t expected = Empty;
+                // A consumer that found the cell still empty may have abandoned it;
+                // in that case the element goes to a later cell instead.
+                if (cell.state.compare_exchange_strong(expected, Writing, ring_order::acquire)) {
+                    new (cell.storage) T(std::forward<U>(item));
+                    cell.state.store(Full, ring_order::release);
+                    if (spare != nullptr) {
+                        release_segment(spare);
+                    }
+                    return true;
+                }
+                continue;
+            }
+
+            // The segment is full: link the spare, or help whoever already linked one.
+            Segment* next = tail->next.load(ring_order::acquire);
+            if (next == nullptr && spare != nullptr &&
+                tail->next.compare_exchange_strong(next, spare, ring_order::release,
+                                                 ring_order::acquire)) {
+                next = spare;
+                spare = nullptr;
+            }
+            if (next != nullptr) {
+                tail_.compare_exchange_strong(tail, next, ring_order::release, ring_order::relaxed);
+                continue;
+            }
+        }
+
+        spare = acquire_segment();
+        if (spare == nullptr) {
+            return false;
+        }
+    }
+}
+
+template <typename T>
+bool UnboundedRing<T>::try_pop(T& out_item) {
+    for (;;) {
+        auto guard = epoch_.pin();
+        Segment* head = head_.load(ring_order::acquire);
+
+        const size_t dequeued = head->dequeue_index.load(ring_order::acquire);
+        const size_t enqueued = head->enqueue_index.load(ring_order::acquire);
+        if (dequeued >= enqueued && head->next.load(ring_order::acquire) == nullptr) {
+            return false;
+        }
+
+        const size_t index = head->dequeue_index.fetch_add(1, ring_order::relaxed);
+        if (index < segment_capacity_) {
+            Cell& cell = head->cells[index];
+            uint8_t state = Empty;
+            if (cell.state.compare_exchange_strong(state, Taken, ring_order::acquire)) {
+                // No producer had reached this cell yet; it stays abandoned.
+                continue;
+            }
+            while (state == Writing) {
+                state = cell.state.load(ring_order::acquire);
+            }
+            T* item = std::launder(reinterpret_cast<T*>(cell.storage));
+            out_item = std::move(*item);
+            item->~T();
+            cell.state.store(Taken, ring_order::relaxed);
+            return true;
+        }
+
+        // The segment is drained: move head past it and recycle it.
+        Segment* next = head->next.load(ring_order::acquire);
+        if (next == nullptr) {
+            return false;
+        }
+        // A segment must never be recycled while it is still the tail.
+        Segment* expected_tail = head;
+        tail_.compare_exchange_strong(expected_tail, next, ring_order::release, ring_order::relaxed);
+        Segment* expected_head = head;
+        if (head_.compare_exchange_strong(expected_head, next, ring_order::release,
+                                            ring_order::relaxed)) {
+            epoch_.retire([this, head] { release_segment(head); });
+        }
+    }
+}
+
+template <typename T>
+bool UnboundedRing<T>::empty() const {
+    Segment* head = head_.load(ring_order::acquire);
+    Segment* tail = tail_.load(ring_order::acquire);
+    if (head != tail) {
+        return false;
+    }
+    const size_t dequeued = head->dequeue_index.load(ring_order::acquire);
+    const size_t enqueued = head->enqueue_index.load(ring_order::acquire);
+    return dequeued >= enqueued || dequeued >= segment_capacity_;
+}
+
+template <typename T>
+size_t UnboundedRing<T>::segment_capacity() const {
+    return segment_capacity_;
+}
+
+template <typename T>
+size_t UnboundedRing<T>::allocated_segments() const {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    return segments_.size();
+}
+
+template <typename T>
+typename UnboundedRing<T>::Segment* UnboundedRing<T>::acquire_segment() {
+    bool empty;
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        empty = free_.empty();
+    }
+    if (empty) {
+        // Reclaims run release_segment(), so the pool lock must not be held here.
+        epoch_.collect();
+    }
+
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    if (!free_.empty()) {
+        Segment* segment = free_.back();
+        free_.pop_back();
+        reset_segment(segment);
+        return segment;
+    }
+    if (segments_.size() >= max_segments_) {
+        return nullptr;
+    }
+    segments_.push_back(std::make_unique<Segment>(segment_capacity_));
+    return segments_.back().get();
+}
+
+template <typename T>
+void UnboundedRing<T>::release_segment(Segment* segment) {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    free_.push_back(segment);
+}
+
+template <typename T>
+void UnboundedRing<T>::reset_segment(Segment* segment) {
+    for (size_t i = 0; i < segment_capacity_; ++i) {
+        segment->cells[i].state.store(Empty, ring_order::relaxed);
+    }
+    segment->next.store(nullptr, ring_order::relaxed);
+    segment->dequeue_index.store(0, ring_order::relaxed);
+    segment->enqueue_index.store(0, ring_order::release);
+}
+
+#endif // RING_BUFFER_UNBOUNDED_HPP
@@ -0,0 +1,186 @@
+#include "ringbuff_uring.hpp"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+#include <vector>
+
+namespace {
+
+int sys_io_uring_setup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int sys_io_uring_register(int fd, unsigned opcode, const void* arg, unsigned nr_args) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+template <typename T>
+T* at_offset(void* base, uint32_t offset) {
+    return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+}
+
+// The kernel updates the shared indices concurrently, so they are accessed atomically.
+unsigned load_acquire(const unsigned* index) {
+    return std::atomic_ref<unsigned>(*const_cast<unsigned*>(index)).load(std::memory_order_acquire);
+}
+
+void store_release(unsigned* index, unsigned value) {
+    std::atomic_ref<unsigned>(*index).store(value, std::memory_order_release);
+}
+
+void* map_queue(int fd, size_t size, off_t offset) {
+    void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+    if (address == MAP_FAILED) {
+        throw std::system_error(errno, std::generic_category(), "io_uring mmap");
+    }
+    return address;
+}
+
+}  // namespace
+
+IoUring::IoUring(unsigned entries) {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    fd_ = sys_io_uring_setup(entries, &params);
+    if (fd_ < 0) {
+        throw std::system_error(errno, std::generic_category(), "io_uring_setup");
+    }
+
+    try {
+        sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) {
+            sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+        }
+
+        sq_ring_ = map_queue(fd_, sq_ring_size_, IORING_OFF_SQ_RING);
+        cq_ring_ = single_mmap ? sq_ring_ : map_queue(fd_, cq_ring_size_, IORING_OFF_CQ_RING);
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(map_queue(fd_, sqes_size_, IORING_OFF_SQES));
+    } catch (...) {
+        release();
+        throw;
+    }
+
+    sq_head_ = at_offset<unsigned>(sq_ring_, params.sq_off.head);
+    sq_tail_ = at_offset<unsigned>(sq_ring_, params.sq_off.tail);
+    sq_array_ = at_offset<unsigned>(sq_ring_, params.sq_off.array);
+    sq_mask_ = *at_offset<unsigned>(sq_ring_, params.sq_off.ring_mask);
+    sq_entries_ = *at_offset<unsigned>(sq_ring_, params.sq_off.ring_entries);
+    sq_pending_tail_ = *sq_tail_;
+
+    cq_head_ = at_offset<unsigned>(cq_ring_, params.cq_off.head);
+    cq_tail_ = at_offset<unsigned>(cq_ring_, params.cq_off.tail);
+    cqes_ = at_offset<io_uring_cqe>(cq_ring_, params.cq_off.cqes);
+    cq_mask_ = *at_offset<unsigned>(cq_ring_, params.cq_off.ring_mask);
+}
+
+IoUring::~IoUring() {
+    release();
+}
+
+void IoUring::release() {
+    if (sqes_ != nullptr) {
+        munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+        munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_ != nullptr) {
+        munmap(sq_ring_, sq_ring_size_);
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+    sqes_ = nullptr;
+    cq_ring_ = sq_ring_ = nullptr;
+    fd_ = -1;
+}
+
+io_uring_sqe* IoUring::get_sqe(IoCompletion* handler) {
+    if (sq_space() == 0) {
+        return nullptr;
+    }
+    const unsigned index = sq_pending_tail_ & sq_mask_;
+    io_uring_sqe* sqe = &sqes_[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->user_data = reinterpret_cast<uint64_t>(handler);
+    sq_array_[index] = index;
+    ++sq_pending_tail_;
+    return sqe;
+}
+
+unsigned IoUring::sq_space() const {
+    return sq_entries_ - (sq_pending_tail_ - load_acquire(sq_head_));
+}
+
+unsigned IoUring::submit(unsigned wait_for) {
+    store_release(sq_tail_, sq_pending_tail_);
+    const unsigned flags = wait_for > 0 ? IORING_ENTER_GETEVENTS : 0;
+    unsigned submitted = 0;
+    for (;;) {
+        // Entries the kernel has not consumed yet, including any left over
+        // from an earlier call that it only partly consumed.
+        const unsigned to_submit = sq_pending_tail_ - load_acquire(sq_head_);
+        if (to_submit == 0 && (wait_for == 0 || submitted > 0)) {
+            return submitted;
+        }
+        int consumed;
+        do {
+            consumed = sys_io_uring_enter(fd_, to_submit, wait_for, flags);
+        } while (consumed < 0 && errno == EINTR);
+        if (consumed < 0) {
+            throw std::system_error(errno, std::generic_category(), "io_uring_enter");
+        }
+        submitted += static_cast<unsigned>(consumed);
+        if (consumed == 0) {
+            // Nothing was taken (only waited); retrying would spin.
+            return submitted;
+        }
+    }
+}
+
+unsigned IoUring::reap() {
+    unsigned head = *cq_head_;
+    const unsigned tail = load_acquire(cq_tail_);
+    unsigned reaped = 0;
+    while (head != tail) {
+        const io_uring_cqe cqe = cqes_[head & cq_mask_];
+        ++head;
+        ++reaped;
+        // Release the entry before dispatching, since a handler may queue more work.
+        store_release(cq_head_, head);
+        if (cqe.user_data != 0) {
+            reinterpret_cast<IoCompletion*>(cqe.user_data)->on_complete(cqe.res, cqe.flags);
+        }
+    }
+    return reaped;
+}
+
+void IoUring::register_buffers(const std::vector<iovec>& buffers) {
+    unregister_buffers();
+    if (sys_io_uring_register(fd_, IORING_REGISTER_BUFFERS, buffers.data(),
+                              static_cast<unsigned>(buffers.size())) < 0) {
+        throw std::system_error(errno, std::generic_category(), "io_uring_register");
+    }
+    buffers_registered_ = true;
+}
+
+void IoUring::unregister_buffers() {
+    if (buffers_registered_) {
+        sys_io_uring_register(fd_, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+        buffers_registered_ = false;
+    }
+}
@@ -0,0 +1,370 @@
+#ifndef RING_BUFFER_URING_HPP
+#define RING_BUFFER_URING_HPP
+
+#include <linux/io_uring.h>  // For io_uring_sqe, io_uring_cqe, IORING_OP_*
+#include <sys/uio.h>         // For iovec
+
+#include <algorithm>     // For std::min
+#include <cerrno>        // For ECANCELED, EINTR, EAGAIN
+#include <cstddef>       // For size_t, std::byte
+#include <cstdint>       // For uint32_t, uint64_t, int64_t
+#include <span>          // For std::span
+#include <system_error>  // For std::system_error
+#include <type_traits>   // For std::is_trivially_copyable_v
+#include <vector>        // For std::vector
+
+#include "ringbuff.hpp"
+
+// io_uring adapters that move RingBuffer contents to and from file descriptors
+// without a system call per operation.
+// A single IoUring instance can serve many rings: adapters only queue
+// submission entries, and one submit() hands the whole batch to the kernel.
+// Adapters hold their ring's storage in flight until the matching completion
+// arrives, so producers must use try_push (not the overwriting push) while a
+// ring is attached to an adapter.
+
+// Receives the completion of a submission entry queued by an adapter.
+class IoCompletion {
+public:
+    // Called from IoUring::reap() with the kernel's result (bytes or -errno).
+    virtual void on_complete(int result, uint32_t flags) = 0;
+
+protected:
+    ~IoCompletion() = default;
+};
+
+// A minimal io_uring instance: one submission and one completion queue.
+class IoUring {
+public:
+    // Most bytes an adapter queues in one operation. sqe->len is 32 bits, and
+    // Linux moves at most this much per read or write (MAX_RW_COUNT) anyway.
+    static constexpr size_t max_io_bytes = 0x7ffff000;
+
+    // Sets up a ring with room for `entries` submission entries.
+    // Throws std::system_error if the kernel refuses.
+    explicit IoUring(unsigned entries = 256);
+
+    // Unmaps the queues and closes the ring. Pending operations are abandoned.
+    ~IoUring();
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    // Returns a zeroed submission entry whose completion goes to `handler`,
+    // or nullptr if the submission queue is full.
+    io_uring_sqe* get_sqe(IoCompletion* handler);
+
+    // Returns the number of submission entries that can still be queued.
+    unsigned sq_space() const;
+
+    // Hands every queued entry to the kernel, optionally waiting for `wait_for`
+    // completions. Usually one system call; calls again while the kernel
+    // consumes only part of the queue. Returns the number of entries submitted.
+    // Throws std::system_error on failure.
+    unsigned submit(unsigned wait_for = 0);
+
+    // Dispatches every available completion to its handler. Returns the number reaped.
+    unsigned reap();
+
+    // Registers fixed buffers for IORING_OP_READ_FIXED/WRITE_FIXED, replacing
+    // any previous registration. Throws std::system_error on failure.
+    void register_buffers(const std::vector<iovec>& buffers);
+
+    // Drops the fixed buffer registration, if any.
+    void unregister_buffers();
+
+private:
+    // Unmaps whatever has been mapped so far and closes the ring.
+    void release();
+
+    int fd_ = -1;                         // The io_uring file descriptor
+    void* sq_ring_ = nullptr;             // Mapped submission queue ring
+    size_t sq_ring_size_ = 0;
+    void* cq_ring_ = nullptr;             // Mapped completion queue ring (may alias sq_ring_)
+    size_t cq_ring_size_ = 0;
+    io_uring_sqe* sqes_ = nullptr;        // Mapped submission entry array
+    size_t sqes_size_ = 0;
+
+    unsigned* sq_head_ = nullptr;         // Kernel-owned consumer index
+    unsigned* sq_tail_ = nullptr;         // Our producer index
+    unsigned* sq_array_ = nullptr;        // Indices into sqes_
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+    unsigned sq_pending_tail_ = 0;        // Entries prepared but not yet published
+
+    unsigned* cq_head_ = nullptr;         // Our consumer index
+    unsigned* cq_tail_ = nullptr;         // Kernel-owned producer index
+    io_uring_cqe* cqes_ = nullptr;
+    unsigned cq_mask_ = 0;
+
+    bool buffers_registered_ = false;
+};
+
+// Returns an iovec covering a ring's whole storage, for IoUring::register_buffers().
+template <typename T>
+iovec storage_iovec(const RingBuffer<T>& ring) {
+    return iovec{const_cast<T*>(ring.data()), ring.capacity() * sizeof(T)};
+}
+
+// Drains a RingBuffer to a file descriptor with IORING_OP_WRITEV, or with
+// IORING_OP_WRITE_FIXED per segment once the ring's storage is registered.
+// The head only advances as completions report bytes written.
+template <typename T>
+class RingWriter : public IoCompletion {
+    static_assert(std::is_trivially_copyable_v<T>, "RingWriter requires a trivially copyable T");
+
+public:
+    // Attaches to `ring` and writes to `fd`, starting at `offset`
+    // (-1 uses and advances the file position, as required for sockets and pipes).
+    RingWriter(IoUring& uring, RingBuffer<T>& ring, int fd, int64_t offset = -1);
+
+    // Switches to IORING_OP_WRITE_FIXED using a registered buffer that covers
+    // the ring's storage, such as one created with storage_iovec().
+    void use_registered_buffer(unsigned buffer_index);
+
+    // Queues a write of every readable element not already in flight.
+    // Returns the number of bytes queued, at most IoUring::max_io_bytes; 0 if
+    // nothing is readable, a write is still in flight or the submission queue
+    // is full.
+    // Throws std::system_error if a previous write failed.
+    size_t prepare();
+
+    // Checks if no write is in flight.
+    bool idle() const;
+
+    // Returns the total number of bytes written so far.
+    uint64_t bytes_written() const;
+
+    void on_complete(int result, uint32_t flags) override;
+
+private:
+    IoUring& uring_;
+    RingBuffer<T>& ring_;
+    int fd_;
+    int64_t offset_;                 // File offset of the next write, or -1
+    bool fixed_ = false;             // Whether to use WRITE_FIXED
+    unsigned buffer_index_ = 0;      // Registered buffer covering the ring
+    size_t front_offset_ = 0;        // Bytes of the front element already written
+    unsigned inflight_sqes_ = 0;     // Entries queued and not yet completed
+    size_t batch_bytes_ = 0;         // Bytes completed in the current batch
+    uint64_t bytes_written_ = 0;
+    int error_ = 0;                  // errno of the first failed write
+    iovec iov_[2] = {};              // Must outlive the WRITEV submission
+};
+
+// Fills a RingBuffer from a socket with IORING_OP_RECV, receiving straight
+// into the ring's free space. The tail only advances as completions arrive.
+template <typename T>
+class RingReader : public IoCompletion {
+    static_assert(std::is_trivially_copyable_v<T>, "RingReader requires a trivially copyable T");
+
+public:
+    // Attaches to `ring` and receives from the socket `fd`.
+    RingReader(IoUring& uring, RingBuffer<T>& ring, int fd);
+
+    // Queues a receive into the first contiguous run of free slots.
+    // Returns the number of bytes requested, at most IoUring::max_io_bytes; 0 if
+    // the ring is full, a receive is in flight, the peer has closed or the
+    // submission queue is full.
+    // Throws std::system_error if a previous receive failed.
+    size_t prepare();
+
+    // Checks if no receive is in flight.
+    bool idle() const;
+
+    // Checks if the peer has closed the connection.
+    bool eof() const;
+
+    // Returns the total number of bytes received so far.
+    uint64_t bytes_read() const;
+
+    void on_complete(int result, uint32_t flags) override;
+
+private:
+    IoUring& uring_;
+    RingBuffer<T>& ring_;
+    int fd_;
+    size_t tail_fill_ = 0;      // Bytes of the next element already received
+    bool inflight_ = false;
+    bool eof_ = false;
+    uint64_t bytes_read_ = 0;
+    int error_ = 0;             // errno of the first failed receive
+};
+
+template <typename T>
+RingWriter<T>::RingWriter(IoUring& uring, RingBuffer<T>& ring, int fd, int64_t offset)
+    : uring_(uring), ring_(ring), fd_(fd), offset_(offset) {}
+
+template <typename T>
+void RingWriter<T>::use_registered_buffer(unsigned buffer_index) {
+    fixed_ = true;
+    buffer_index_ = buffer_index;
+}
+
+template <typename T>
+size_t RingWriter<T>::prepare() {
+    if (error_ != 0) {
+        throw std::system_error(error_, std::generic_category(), "RingWriter write failed");
+    }
+    if (inflight_sqes_ != 0) {
+        return 0;
+    }
+
+    auto [first, second] = ring_.segments();
+    std::span<const std::byte> head = std::as_bytes(first).subspan(first.empty() ? 0 : front_offset_);
+    std::span<const std::byte> tail = std::as_bytes(second);
+    if (head.empty() && tail.empty()) {
+        return 0;
+    }
+    // Longer runs go out over several prepare() calls.
+    if (head.size() >= IoUring::max_io_bytes) {
+        head = head.first(IoUring::max_io_bytes);
+        tail = {};
+    } else {
+        tail = tail.first(std::min(tail.size(), IoUring::max_io_bytes - head.size()));
+    }
+    const unsigned needed = (fixed_ && !head.empty() && !tail.empty()) ? 2 : 1;
+    if (uring_.sq_space() < needed) {
+        return 0;
+    }
+
+    const uint64_t file_offset = static_cast<uint64_t>(offset_);
+    if (!fixed_) {
+        unsigned count = 0;
+        for (std::span<const std::byte> part : {head, tail}) {
+            if (!part.empty()) {
+                iov_[count++] = iovec{const_cast<std::byte*>(part.data()), part.size()};
+            }
+        }
+        io_uring_sqe* sqe = uring_.get_sqe(this);
+        sqe->opcode = IORING_OP_WRITEV;
+        sqe->fd = fd_;
+        sqe->off = file_offset;
+        sqe->addr = reinterpret_cast<uint64_t>(iov_);
+        sqe->len = count;
+        inflight_sqes_ = 1;
+    } else {
+        // One entry per contiguous segment, linked so the second only starts
+        // once the first has fully completed.
+        uint64_t next_offset = file_offset;
+        for (std::span<const std::byte> part : {head, tail}) {
+            if (part.empty()) {
+                continue;
+            }
+            io_uring_sqe* sqe = uring_.get_sqe(this);
+            sqe->opcode = IORING_OP_WRITE_FIXED;
+            sqe->fd = fd_;
+            sqe->off = next_offset;
+            sqe->addr = reinterpret_cast<uint64_t>(part.data());
+            sqe->len = static_cast<uint32_t>(part.size());
+            sqe->buf_index = static_cast<uint16_t>(buffer_index_);
+            if (++inflight_sqes_ < needed) {
+                sqe->flags |= IOSQE_IO_LINK;
+            }
+            if (offset_ >= 0) {
+                next_offset += part.size();
+            }
+        }
+    }
+    return head.size() + tail.size();
+}
+
+template <typename T>
+bool RingWriter<T>::idle() const {
+    return inflight_sqes_ == 0;
+}
+
+template <typename T>
+uint64_t RingWriter<T>::bytes_written() const {
+    return bytes_written_;
+}
+
+template <typename T>
+void RingWriter<T>::on_complete(int result, uint32_t) {
+    --inflight_sqes_;
+    if (result >= 0) {
+        batch_bytes_ += static_cast<size_t>(result);
+    } else if (result != -ECANCELED && error_ == 0) {
+        // A short first write cancels its linked successor; that is not an error.
+        error_ = -result;
+    }
+    if (inflight_sqes_ != 0) {
+        return;
+    }
+
+    const size_t total = front_offset_ + batch_bytes_;
+    ring_.discard(total / sizeof(T));
+    front_offset_ = total % sizeof(T);
+    bytes_written_ += batch_bytes_;
+    if (offset_ >= 0) {
+        offset_ += static_cast<int64_t>(batch_bytes_);
+    }
+    batch_bytes_ = 0;
+}
+
+template <typename T>
+RingReader<T>::RingReader(IoUring& uring, RingBuffer<T>& ring, int fd)
+    : uring_(uring), ring_(ring), fd_(fd) {}
+
+template <typename T>
+size_t RingReader<T>::prepare() {
+    if (error_ != 0) {
+        throw std::system_error(error_, std::generic_category(), "RingReader receive failed");
+    }
+    if (inflight_ || eof_) {
+        return 0;
+    }
+    std::span<std::byte> space = std::as_writable_bytes(ring_.free_segments().first);
+    if (space.size() <= tail_fill_) {
+        return 0;
+    }
+    space = space.subspan(tail_fill_);
+    space = space.first(std::min(space.size(), IoUring::max_io_bytes));
+
+    io_uring_sqe* sqe = uring_.get_sqe(this);
+    if (sqe == nullptr) {
+        return 0;
+    }
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd_;
+    sqe->addr = reinterpret_cast<uint64_t>(space.data());
+    sqe->len = static_cast<uint32_t>(space.size());
+    inflight_ = true;
+    return space.size();
+}
+
+template <typename T>
+bool RingReader<T>::idle() const {
+    return !inflight_;
+}
+
+template <typename T>
+bool RingReader<T>::eof() const {
+    return eof_;
+}
+
+template <typename T>
+uint64_t RingReader<T>::bytes_read() const {
+    return bytes_read_;
+}
+
+template <typename T>
+void RingReader<T>::on_complete(int result, uint32_t) {
+    inflight_ = false;
+    if (result == 0) {
+        eof_ = true;
+        return;
+    }
+    if (result < 0) {
+        if (result != -EINTR && result != -EAGAIN && error_ == 0) {
+            error_ = -result;
+        }
+        return;
+    }
+    const size_t total = tail_fill_ + static_cast<size_t>(result);
+    ring_.commit(total / sizeof(T));
+    tail_fill_ = total % sizeof(T);
+    bytes_read_ += static_cast<uint64_t>(result);
+}
+
+#endif // RING_BUFFER_URING_HPP